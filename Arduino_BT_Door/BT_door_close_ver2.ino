@@ -16,14 +16,53 @@ const int OPEN_MS   = 850;
 const int CLOSE_MS  = 950;
 
 const int  BRAKE_MS                 = 200; // 모터 제동 시간(브레이크 유지 시간)
-const unsigned long SENSOR_DEBOUNCE_MS          = 150; (리드 스위치 안정화 시간)
+const unsigned long SENSOR_DEBOUNCE_MS          = 150;  // 리드 스위치 안정화 시간
 const unsigned long OPEN_SIGNAL_TIMEOUT_MS      = 3000; // 마지막 OPEN 이후 3초 후 닫힘
 const unsigned long AFTER_REED_CLOSE_DELAY_MS   = 1000; // 리드 HIGH->LOW 전환 후 1초 후 닫힘
 const unsigned long MOVE_LOCKOUT_MS             = 1500; // 모션 종료 후 명령 무시
 
+// ===== 통신 프로토콜 =====
+// SERIAL_FRAMED 1: 프레임 [0xA5][길이][순번][opcode][payload][CRC8] (recognize의 SerialFrame.h와 같은 정의)
+//                  응답은 명령 순번을 담은 ACK/ACTION/DONE, 텔레메트리(모터 시간/리드 변화/모터 단계)
+// SERIAL_FRAMED 0: 기존 ASCII 줄 ("OPEN\n" → "ACTION: OPEN" ...), 호스트는 SERIAL_PROTOCOL=ascii
+// 수신은 두 방식 모두 고정 버퍼 (String 누적/할당 없음)
+#define SERIAL_FRAMED 1
+
+const byte FRAME_SYNC        = 0xA5;
+const byte FRAME_MAX_PAYLOAD = 16;
+const byte LINE_MAX          = 32;  // ASCII 명령 최대 길이
+
+enum FrameOp {
+  OP_OPEN = 0x01, OP_CLOSE = 0x02, OP_STATUS = 0x03,               // 호스트 → 장치
+  OP_ACK = 0x80, OP_ACTION = 0x81, OP_DONE = 0x82, OP_REED = 0x83,  // 장치 → 호스트
+  OP_PHASE = 0x84, OP_STATE = 0x85, OP_READY = 0x86
+};
+enum AckStatus { ACK_ACCEPTED = 0, ACK_BUSY = 1, ACK_LOCKOUT = 2, ACK_PENDING = 3, ACK_AUTO = 4, ACK_UNKNOWN = 5 };
+
+// 포트별 수신 상태 (함수 프로토타입 자동 생성보다 앞에 있어야 해서 위에 정의)
+struct RxState {
+  byte frame[FRAME_MAX_PAYLOAD + 4]; // 길이, 순번, opcode, payload, CRC (동기 바이트 제외)
+  byte have;                         // 0=동기 바이트 대기
+  char line[LINE_MAX + 1];
+  byte lineLen;
+};
+RxState usbRx, btRx; // USB / 블루투스
+
+// ===== 모터 상태 머신 =====
+// delay() 없이 millis()로 단계 전환 → 모터가 도는 동안에도 loop()가 계속 돌아
+// 명령 파싱(SoftwareSerial 64바이트 수신 버퍼)과 리드 스위치 디바운스가 멈추지 않음
+//   IDLE → DRIVE(OPEN_MS/CLOSE_MS) → BRAKE(BRAKE_MS) → LOCKOUT(MOVE_LOCKOUT_MS) → IDLE
+// 단계가 바뀔 때마다 단계 이벤트 출력(ASCII "PHASE: <단계>" / 프레임 OP_PHASE)
+enum MotorPhase { PHASE_IDLE, PHASE_DRIVE, PHASE_BRAKE, PHASE_LOCKOUT };
+const char* const PHASE_NAMES[] = { "IDLE", "DRIVE", "BRAKE", "LOCKOUT" };
+
+MotorPhase phase = PHASE_IDLE;             // 현재 단계
+unsigned long phaseStartedAt = 0;          // 현재 단계 시작 시각
+bool movingOpen = false;                   // 진행 중인 동작 방향(true=OPEN, false=CLOSE)
+byte movingSeq = 0;                        // 동작을 시킨 명령 순번(0=자동 닫힘)
+unsigned long driveMsMeasured = 0;         // 실제 구동 시간(DRIVE 단계 길이, 텔레메트리)
+
 // ===== 상태 변수 =====
-volatile bool motorBusy = false;           // 모터의 현재 상태(회전 중인지)
-unsigned long lastMoveEndAt = 0;           // 마지막 모션 종료 시각
 unsigned long lastOpenAt    = 0;           // 마지막 OPEN 수신 시각(0이면 아직 없음)
 
 bool reedLowStable = false;                // 안정화된 리드 상태(LOW=자석 감지=닫힘)
@@ -32,6 +71,82 @@ unsigned long reedChangedAt = 0;           // 리드 상태 변화 시각(디바
 bool pendingCloseUntilReedLow = false;     // 닫힘 대기 모드인지(OPEN 이후 3초 -> 리드 HIGH)
 unsigned long reedLowDetectedAt = 0;       // 닫힘 대기 중(리드 LOW로 바뀐 순간 시각 : 1초 지연)
 
+// ===== 응답 출력: USB/BT 양쪽 (호스트가 어느 쪽으로 연결해도 응답을 받도록) =====
+// ASCII 안내 줄 (프레임 모드에서는 보내지 않음 → 호스트 파서에 잡음이 섞이지 않도록)
+void say(const char* a, const char* b = "") {
+#if !SERIAL_FRAMED
+  Serial.print(a); Serial.println(b);
+  bt.print(a);     bt.println(b);
+#endif
+}
+
+byte crc8(const byte* data, byte n) { // 다항식 0x07, 초기값 0
+  byte crc = 0;
+  for (byte i = 0; i < n; i++) {
+    crc ^= data[i];
+    for (byte bit = 0; bit < 8; bit++) crc = (crc & 0x80) ? (byte)((crc << 1) ^ 0x07) : (byte)(crc << 1);
+  }
+  return crc;
+}
+
+byte txSeq = 0; // 장치가 보내는 프레임 순번
+void sendFrame(byte op, const byte* payload, byte len) {
+  byte f[FRAME_MAX_PAYLOAD + 5];
+  f[0] = FRAME_SYNC; f[1] = len; f[2] = ++txSeq; f[3] = op;
+  for (byte i = 0; i < len; i++) f[4 + i] = payload[i];
+  f[4 + len] = crc8(f + 1, len + 3);
+  Serial.write(f, len + 5);
+  bt.write(f, len + 5);
+}
+
+// ===== 상태 보고 (프레임 / ASCII 한 곳에서 선택) =====
+void reportAck(byte seq, byte status) { // 프레임 전용: 명령 수신 확인
+#if SERIAL_FRAMED
+  const byte p[2] = { seq, status };
+  sendFrame(OP_ACK, p, 2);
+#endif
+}
+
+void reportIgnored(byte seq, bool open, byte status) {
+#if SERIAL_FRAMED
+  reportAck(seq, status);
+#else
+  static const char* const REASONS[] = { "", " IGNORED: busy", " IGNORED: lockout", " IGNORED: pending (waiting reed LOW)" };
+  Serial.print(open ? "OPEN" : "CLOSE"); Serial.println(REASONS[status]);
+  bt.print(open ? "OPEN" : "CLOSE");     bt.println(REASONS[status]);
+#endif
+}
+
+void reportAction() {
+#if SERIAL_FRAMED
+  const byte p[2] = { movingSeq, (byte)(movingOpen ? OP_OPEN : OP_CLOSE) };
+  sendFrame(OP_ACTION, p, 2);
+#else
+  say("ACTION: ", movingOpen ? "OPEN" : "CLOSE");
+#endif
+}
+
+void reportDone(unsigned long brakeMs) {
+#if SERIAL_FRAMED
+  const byte p[6] = { movingSeq, (byte)(movingOpen ? OP_OPEN : OP_CLOSE),
+                      (byte)(driveMsMeasured & 0xFF), (byte)(driveMsMeasured >> 8),
+                      (byte)(brakeMs & 0xFF), (byte)(brakeMs >> 8) };
+  sendFrame(OP_DONE, p, 6);
+#else
+  (void)brakeMs;
+  say("DONE: ", movingOpen ? "OPEN" : "CLOSE");
+#endif
+}
+
+void reportReed(bool closed) {
+#if SERIAL_FRAMED
+  const byte p[1] = { (byte)(closed ? 1 : 0) };
+  sendFrame(OP_REED, p, 1);
+#else
+  say("REED: ", closed ? "CLOSED" : "OPEN");
+#endif
+}
+
 // ===== 모터 제어 유틸 =====
 static inline void motorCoast() { // 모터 정지
   analogWrite(EN, 0);
@@ -39,63 +154,79 @@ static inline void motorCoast() { // 모터 정지
   digitalWrite(IN2, LOW);
 }
 
-static inline void motorBrake() { // 모터 제동 -> 위치 고정
+static inline void motorBrakeOn() { // 모터 제동 -> 위치 고정 (BRAKE 단계 동안 유지)
   digitalWrite(IN1, HIGH);
   digitalWrite(IN2, HIGH);
   analogWrite(EN, 255);
-  
-  delay(BRAKE_MS);
-  
-  analogWrite(EN, 0);
-  digitalWrite(IN1, LOW);
-  digitalWrite(IN2, LOW);
 }
-// 모터 구동(open/close)
-static inline void openLock() {
-  // 모터 회전 중 또는 마지막 동작 후 1.5초가 안지났다면 무시
-  if (motorBusy) { Serial.println("OPEN IGNORED: busy"); return; }
-  if (millis() - lastMoveEndAt < MOVE_LOCKOUT_MS) { Serial.println("OPEN IGNORED: lockout"); return; }
 
-  // 모터 회전 중...
-  motorBusy = true;
-  Serial.println("ACTION: OPEN");
-  // 정방향
-  digitalWrite(IN1, HIGH);
-  digitalWrite(IN2, LOW);
-  // PWM 속도 제어
-  analogWrite(EN, OPEN_PWM);
-  // 일정 시간동안 회전
-  delay(OPEN_MS);
-  // 모터 회전 종료... 상태 기록
-  motorBrake();
-  lastMoveEndAt = millis();
-  motorBusy = false;
-  
-  Serial.println("DONE: OPEN");
-}
-static inline void closeLock() {
-  // 모터 회전 중 또는 마지막 동작 후 1.5초가 안지났다면 무시
-  if (motorBusy) { Serial.println("CLOSE IGNORED: busy"); return; }
-  if (millis() - lastMoveEndAt < MOVE_LOCKOUT_MS) { Serial.println("CLOSE IGNORED: lockout"); return; }
-
-  // 모터 회전 중...
-  motorBusy = true;
-  Serial.println("ACTION: CLOSE");
-  // 역방향
-  digitalWrite(IN1, LOW);
-  digitalWrite(IN2, HIGH);
+void enterPhase(MotorPhase next) {
+  phase = next;
+  phaseStartedAt = millis();
+#if SERIAL_FRAMED
+  const byte p[1] = { (byte)next };
+  sendFrame(OP_PHASE, p, 1);
+#else
+  say("PHASE: ", PHASE_NAMES[next]);
+#endif
+}
+
+// 지금 모터를 움직일 수 있는지 (회전/제동 중이면 busy, 잠금 시간이면 lockout)
+byte moveStatus() {
+  if (phase == PHASE_DRIVE || phase == PHASE_BRAKE) return ACK_BUSY;
+  if (phase == PHASE_LOCKOUT) return ACK_LOCKOUT;
+  return ACK_ACCEPTED;
+}
+
+// 모터 구동 시작(open/close), seq: 명령 순번(0=자동). 움직일 수 없으면 무시 보고 후 false
+bool startMove(bool open, byte seq) {
+  const byte st = moveStatus();
+  if (st != ACK_ACCEPTED) { reportIgnored(seq, open, st); return false; }
+  if (seq != 0) reportAck(seq, ACK_ACCEPTED);
+
+  movingOpen = open;
+  movingSeq = seq;
+  reportAction();
+  // 정방향(OPEN) / 역방향(CLOSE)
+  digitalWrite(IN1, open ? HIGH : LOW);
+  digitalWrite(IN2, open ? LOW : HIGH);
   // PWM 속도 제어
-  analogWrite(EN, CLOSE_PWM);
-  // 일정 시간동안 회전
-  delay(CLOSE_MS);
-  // 모터 회전 종료... 상태 기록
-  motorBrake();
-  lastMoveEndAt = millis();
-  motorBusy = false;
-  
-  Serial.println("DONE: CLOSE");
+  analogWrite(EN, open ? OPEN_PWM : CLOSE_PWM);
+  enterPhase(PHASE_DRIVE);
+  return true;
+}
+
+// 매 loop()마다 호출: 시간이 된 단계만 다음으로 넘김
+void updateMotor() {
+  const unsigned long elapsed = millis() - phaseStartedAt;
+  switch (phase) {
+    case PHASE_DRIVE:
+      // 일정 시간 회전 후 제동
+      if (elapsed >= (unsigned long)(movingOpen ? OPEN_MS : CLOSE_MS)) {
+        motorBrakeOn();
+        driveMsMeasured = elapsed;
+        enterPhase(PHASE_BRAKE);
+      }
+      break;
+    case PHASE_BRAKE:
+      // 제동 끝 → 동작 완료 보고, 잠금 시간 시작
+      if (elapsed >= (unsigned long)BRAKE_MS) {
+        motorCoast();
+        reportDone(elapsed);
+        enterPhase(PHASE_LOCKOUT);
+      }
+      break;
+    case PHASE_LOCKOUT:
+      if (elapsed >= MOVE_LOCKOUT_MS)
+        enterPhase(PHASE_IDLE);
+      break;
+    case PHASE_IDLE:
+      break;
+  }
 }
 
+static inline void closeLock() { startMove(false, 0); } // 자동 닫힘 (호스트 명령 아님)
+
 // ===== 리드 스위치 디바운스 갱신 =====
 void updateReedStable() {
   static int lastRaw = HIGH;
@@ -108,35 +239,75 @@ void updateReedStable() {
     reedChangedAt = now;
   }
   // 변화 후 일정시간(0.5초)이 경과했는지 확인
-  if (now - reedChangedAt >= SENSOR_DEBOUNCE_MS) {
+  if (now - reedChangedAt >= SENSOR_DEBOUNCE_MS && reedLowStable != (raw == LOW)) {
     reedLowStable = (raw == LOW); // 안정된 상태(LOW) 업데이트
+    reportReed(reedLowStable);    // 텔레메트리: 안정 상태가 바뀔 때만
   }
 }
 
-// ===== 명령 파서: CR/LF 구분, OPEN만 처리 =====
-void parseStream(Stream& s) {
-  static String buf;
+// ===== 명령 처리 (프레임/ASCII 공통) =====
+void handleCommand(byte op, byte seq) {
+  if (op == OP_OPEN) { // OPEN 이면 도어락 열기
+    // 리드 LOW(도어락은 열렸지만 실제 문을 열지 않은 경우) 대기 동안에는 OPEN 무시
+    if (pendingCloseUntilReedLow) { reportIgnored(seq, true, ACK_PENDING); return; }
+    startMove(true, seq);
+    lastOpenAt = millis();       // 마지막 OPEN 시각 갱신 (회전 중이어도 열림 유지)
+  } else if (op == OP_CLOSE) {
+    reportAck(seq, ACK_AUTO);    // 닫기는 리드 스위치 기준 자동 닫힘이 담당
+  } else if (op == OP_STATUS) {
+    reportAck(seq, ACK_ACCEPTED);
+#if SERIAL_FRAMED
+    const byte p[3] = { (byte)(lastOpenAt > 0 ? 1 : 0), (byte)(reedLowStable ? 1 : 0), (byte)phase };
+    sendFrame(OP_STATE, p, 3);
+#endif
+  } else {
+    reportAck(seq, ACK_UNKNOWN);
+  }
+}
+
+// ===== 수신 파서: 포트별 고정 버퍼, 한 번에 도착한 바이트만 처리(대기 없음) =====
+#if SERIAL_FRAMED
+// 프레임: 동기 → 길이 → ... → CRC, 길이 범위 밖/CRC 불일치면 버리고 다음 동기 바이트부터
+void feedFrame(RxState& rx, byte c) {
+  if (rx.have == 0) { if (c == FRAME_SYNC) rx.have = 1; return; }
+  rx.frame[rx.have - 1] = c;
+  rx.have++;
+  const byte len = rx.frame[0];
+  if (len > FRAME_MAX_PAYLOAD) { rx.have = (c == FRAME_SYNC) ? 1 : 0; return; }
+  if (rx.have - 1 < len + 4) return;
+  rx.have = 0;
+  if (crc8(rx.frame, len + 3) != rx.frame[len + 3]) return;
+  handleCommand(rx.frame[2], rx.frame[1]);
+}
+#else
+// ASCII: CR/LF 구분, 대소문자 무시, 앞뒤 공백 제거, 너무 긴 줄은 앞부분 버림
+void feedLine(RxState& rx, char c) {
+  if (c == '\r' || c == '\n') { // 엔터(줄바꿈)시 명령 확정
+    byte n = rx.lineLen;
+    while (n > 0 && rx.line[n - 1] == ' ') n--;
+    rx.line[n] = '\0';
+    const char* cmd = rx.line;
+    while (*cmd == ' ') cmd++;
+    if (strcasecmp(cmd, "OPEN") == 0) handleCommand(OP_OPEN, 0);
+    rx.lineLen = 0; // 버퍼 초기화
+    return;
+  }
+  if (rx.lineLen >= LINE_MAX) { // 버퍼에 명령 누적(32자까지)
+    memmove(rx.line, rx.line + 1, LINE_MAX - 1);
+    rx.lineLen = LINE_MAX - 1;
+  }
+  rx.line[rx.lineLen++] = c;
+}
+#endif
+
+void parseStream(Stream& s, RxState& rx) {
   while (s.available()) { // 시리얼 버퍼에 데이터가 있는 경우
-    char c = s.read();
-    if (c == '\r' || c == '\n') { // 엔터(줄바꿈)시 명령 확정
-      buf.trim();
-      if (buf.length()) {
-        String cmd = buf; cmd.toUpperCase();
-        if (cmd == "OPEN") { // OPEN 이면 도어락 열기
-          // 리드 LOW(도어락은 열렸지만 실제 문을 열지 않은 경우) 대기 동안에는 OPEN 무시
-          if (!pendingCloseUntilReedLow) {
-            openLock();
-            lastOpenAt = millis();       // 마지막 OPEN 시각 갱신
-          } else {
-            Serial.println("OPEN IGNORED: pending (waiting reed LOW)");
-          }
-        }
-      }
-      buf = ""; // 버퍼 초기화
-    } else { // 버퍼에 명령 누적(32자까지)
-      buf += c;
-      if (buf.length() > 32) buf.remove(0, buf.length()-32);
-    }
+    const int c = s.read();
+#if SERIAL_FRAMED
+    feedFrame(rx, (byte)c);
+#else
+    feedLine(rx, (char)c);
+#endif
   }
 }
 
@@ -155,29 +326,36 @@ void setup() {
   pinMode(DOOR, INPUT_PULLUP);
   updateReedStable();
   // 나머지 변수 초기화
+  phase = PHASE_IDLE;
   lastOpenAt = 0;
   pendingCloseUntilReedLow = false;
   reedLowDetectedAt = 0;
 
-  Serial.println("READY");
+#if SERIAL_FRAMED
+  sendFrame(OP_READY, nullptr, 0);
+#else
+  say("READY");
+#endif
 }
 
 void loop() {
   // 1) 입력 파싱 (USB/BT)
-  parseStream(Serial);
-  parseStream(bt);
+  parseStream(Serial, usbRx);
+  parseStream(bt, btRx);
 
-  // 2) 리드 스위치 안정 상태 갱신
+  // 2) 리드 스위치 안정 상태 갱신 + 모터 단계 진행 (둘 다 매 반복, 대기 없음)
   updateReedStable();
+  updateMotor();
 
   // 3) 닫힘 로직: "마지막 OPEN 이후 3초 동안 OPEN이 더 안 온 경우"에만 동작
   const unsigned long now = millis();
   const bool openTimedOut = (lastOpenAt > 0) && (now - lastOpenAt > OPEN_SIGNAL_TIMEOUT_MS);
 
-  if (openTimedOut) {
+  // 자동 닫기는 모터가 쉬고 있을 때만 시도 (잠금 시간 중이면 끝난 뒤 다음 반복에서)
+  if (openTimedOut && phase == PHASE_IDLE) {
     if (reedLowStable) {
       // 3-1) 이미 리드 LOW(닫힘) → 즉시 닫기
-      Serial.println("AUTO: CLOSE immediately (timeout & reed LOW)");
+      say("AUTO: CLOSE immediately (timeout & reed LOW)");
       closeLock();
       // 모든 상태 초기화 → 다음 OPEN 대기
       pendingCloseUntilReedLow = false;
@@ -186,17 +364,17 @@ void loop() {
     } else {
       // 3-2) 리드 HIGH(열림) → LOW로 바뀔 때까지 OPEN 무시
       if (!pendingCloseUntilReedLow) {
-        Serial.println("AUTO: enter pending; ignore OPEN until reed LOW");
+        say("AUTO: enter pending; ignore OPEN until reed LOW");
       }
       pendingCloseUntilReedLow = true;
       // 3-3) LOW 안정화 -> 1초 후 닫기(closeLock)
       if (reedLowStable) {
         if (reedLowDetectedAt == 0) {
           reedLowDetectedAt = now;
-          Serial.println("AUTO: reed LOW detected, start 1s timer");
+          say("AUTO: reed LOW detected, start 1s timer");
         }
         if (now - reedLowDetectedAt >= AFTER_REED_CLOSE_DELAY_MS) {
-          Serial.println("AUTO: CLOSE after 1s (reed HIGH->LOW)");
+          say("AUTO: CLOSE after 1s (reed HIGH->LOW)");
           closeLock();
           // 초기화 → 다음 OPEN 대기
           pendingCloseUntilReedLow = false;
@@ -211,5 +389,5 @@ void loop() {
   }
 
   // 4) 안전 유휴 (드라이버를 불필요하게 켜두지 않기)
-  if (!motorBusy) motorCoast();
+  if (phase == PHASE_IDLE || phase == PHASE_LOCKOUT) motorCoast();
 }
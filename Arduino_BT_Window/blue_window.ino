@@ -5,45 +5,165 @@ SoftwareSerial BT(2,3); // HC-05: TX->D2, RX<-D3(분압)
 const int IN1=5, IN2=6; // 모터 방향 제어 핀
 byte st=0; // 현재 동작상태(0=IDLE,1=OPENING,2=CLOSING)
 const unsigned long RUN_MS = 1000; // 모터 회전 시간
-unsigned long tStart = 0; // 모터 동작 시간
-String state = "CLOSED"; // 현재 상태 저장
+unsigned long tStart = 0; // 모터 동작 시작 시각(millis)
+bool opened = false; // 현재 상태 저장(true=OPENED, false=CLOSED)
+
+// ===== 통신 프로토콜 =====
+// SERIAL_FRAMED 1: 프레임 [0xA5][길이][순번][opcode][payload][CRC8] (recognize의 SerialFrame.h와 같은 정의)
+//                  명령마다 순번을 담은 ACK, 동작 완료 시 DONE(실제 회전 시간)
+// SERIAL_FRAMED 0: ASCII 줄 ("OPEN" → "ACK OPEN", 완료 시 "EVT OPENED 1002ms" = 실제 회전 시간)
+// 수신은 두 방식 모두 도착한 바이트만 고정 버퍼에 누적 (readStringUntil 대기 없음 → 모터 정지가 늦지 않음)
+#define SERIAL_FRAMED 1
+
+const byte FRAME_SYNC = 0xA5;
+const byte FRAME_MAX_PAYLOAD = 16;
+const byte LINE_MAX = 16; // ASCII 명령 최대 길이
+enum { OP_OPEN=0x01, OP_CLOSE=0x02, OP_STATUS=0x03, OP_ACK=0x80, OP_ACTION=0x81, OP_DONE=0x82, OP_STATE=0x85, OP_READY=0x86 };
+enum { ACK_ACCEPTED=0, ACK_UNKNOWN=5 };
+
+// 포트별 수신 상태 (고정 버퍼, 함수 프로토타입 자동 생성보다 앞에 정의)
+struct RxState {
+  byte buf[FRAME_MAX_PAYLOAD + 4]; // 프레임: 길이, 순번, opcode, payload, CRC (동기 바이트 제외)
+  byte have;                       // 0=동기 바이트 대기
+  char line[LINE_MAX + 1];         // ASCII 줄
+  byte lineLen;
+  bool overflow;                   // 줄이 너무 길면 줄바꿈까지 버림
+};
+RxState usbRx, btRx;
+byte cmdSeq = 0; // 진행 중인 동작을 시킨 명령 순번
+byte txSeq = 0;  // 장치가 보내는 프레임 순번
 
 void setup(){
   Serial.begin(9600);
   BT.begin(9600);
-  
-  pinMode(IN1,OUTPUT); 
+
+  pinMode(IN1,OUTPUT);
   pinMode(IN2,OUTPUT);
-  
+
   stopM(); // 처음엔 모터 정지
+#if SERIAL_FRAMED
+  sendFrame(OP_READY, 0, 0);
+#else
   Serial.println("READY"); BT.println("READY");
+#endif
 }
 
 void loop(){
-  handle(Serial);
-  handle(BT);
-
-  // 1초 지나면 동작 완료 → 상태 확정
-  if(st!=0 && millis()-tStart >= RUN_MS){
-    if(st==1) state="OPENED";
-    else      state="CLOSED";
-    stopM();
-
-    Serial.print("EVT "); 
-    Serial.println(state);
-    BT.print("EVT ");    
-    BT.println(state);
+#if SERIAL_FRAMED
+  parseFrames(Serial, usbRx);
+  parseFrames(BT, btRx);
+#else
+  parseLines(Serial, usbRx);
+  parseLines(BT, btRx);
+#endif
+
+  // 1초 지나면 동작 완료 → 상태 확정 (loop가 막히지 않으므로 RUN_MS 직후 정지)
+  checkStop();
+}
+
+// 모터 정지 시각 확인: 정지 직전 millis()로 실제 회전 시간을 재서 완료 이벤트에 담음
+void checkStop(){
+  if(st==0) return;
+  const unsigned long runMs = millis()-tStart;
+  if(runMs < RUN_MS) return;
+
+  const byte doneOp = (st==1) ? OP_OPEN : OP_CLOSE;
+  stopM();
+  opened = (doneOp==OP_OPEN);
+
+#if SERIAL_FRAMED
+  // 텔레메트리: 실제 회전 시간(ms), 창문은 제동 단계 없음
+  const byte p[6] = { cmdSeq, doneOp, (byte)(runMs & 0xFF), (byte)(runMs >> 8), 0, 0 };
+  sendFrame(OP_DONE, p, 6);
+#else
+  // "EVT OPENED 1002ms" (호스트가 명령 → 완료 지연을 잴 수 있도록)
+  Serial.print("EVT "); Serial.print(stateName()); Serial.print(' '); Serial.print(runMs); Serial.println("ms");
+  BT.print("EVT ");     BT.print(stateName());     BT.print(' ');     BT.print(runMs);     BT.println("ms");
+#endif
+}
+
+const char* stateName(){ return opened ? "OPENED" : "CLOSED"; }
+
+// ===== ASCII 줄 =====
+// 도착한 바이트만 누적, CR/LF에서 명령 확정 (대소문자 무시, 앞뒤 공백 제거)
+void parseLines(Stream& io, RxState& rx){
+  while(io.available()){
+    const char c = io.read();
+    if(c=='\r' || c=='\n'){
+      if(!rx.overflow && rx.lineLen>0){
+        byte n=rx.lineLen;
+        while(n>0 && (rx.line[n-1]==' ' || rx.line[n-1]=='\t')) n--;
+        rx.line[n]='\0';
+        const char* s=rx.line;
+        while(*s==' ' || *s=='\t') s++;
+        handleLine(io, s);
+      }
+      rx.lineLen=0;
+      rx.overflow=false;
+      checkStop(); // 명령 하나 처리할 때마다 정지 시각 확인
+      continue;
+    }
+    if(rx.lineLen>=LINE_MAX){ rx.overflow=true; continue; }
+    rx.line[rx.lineLen++]=c;
   }
 }
 
-void handle(Stream& io){
-  if(!io.available()) return;
-  String s=io.readStringUntil('\n'); 
-  s.trim();
+void handleLine(Stream& io, const char* s){
+  if(strcasecmp(s,"OPEN")==0)        { openM();  io.println("ACK OPEN"); }
+  else if(strcasecmp(s,"CLOSE")==0)  { closeM(); io.println("ACK CLOSE"); }
+  else if(strcasecmp(s,"STATUS")==0) printStatus(io);
+}
+
+// ===== 프레임 =====
+byte crc8(const byte* data, byte n){ // 다항식 0x07, 초기값 0
+  byte crc=0;
+  for(byte i=0;i<n;i++){
+    crc^=data[i];
+    for(byte b=0;b<8;b++) crc = (crc&0x80) ? (byte)((crc<<1)^0x07) : (byte)(crc<<1);
+  }
+  return crc;
+}
 
-  if(s.equalsIgnoreCase("OPEN"))  { openM();  io.println("ACK OPEN"); }
-  else if(s.equalsIgnoreCase("CLOSE")) { closeM(); io.println("ACK CLOSE"); }
-  else if(s.equalsIgnoreCase("STATUS")) printStatus(io);
+void sendFrame(byte op, const byte* payload, byte len){ // USB/BT 양쪽으로
+  byte f[FRAME_MAX_PAYLOAD + 5];
+  f[0]=FRAME_SYNC; f[1]=len; f[2]=++txSeq; f[3]=op;
+  for(byte i=0;i<len;i++) f[4+i]=payload[i];
+  f[4+len]=crc8(f+1, len+3);
+  Serial.write(f, len+5);
+  BT.write(f, len+5);
+}
+
+// 도착한 바이트만 처리(대기 없음), 길이 범위 밖/CRC 불일치면 버리고 다음 동기 바이트부터
+void parseFrames(Stream& io, RxState& rx){
+  while(io.available()){
+    const byte c = io.read();
+    if(rx.have==0){ if(c==FRAME_SYNC) rx.have=1; continue; }
+    rx.buf[rx.have-1]=c;
+    rx.have++;
+    const byte len=rx.buf[0];
+    if(len>FRAME_MAX_PAYLOAD){ rx.have = (c==FRAME_SYNC) ? 1 : 0; continue; }
+    if(rx.have-1 < len+4) continue;
+    rx.have=0;
+    if(crc8(rx.buf, len+3)==rx.buf[len+3]) handleFrame(rx.buf[2], rx.buf[1]);
+  }
+}
+
+void handleFrame(byte op, byte seq){
+  byte ack[2] = { seq, ACK_ACCEPTED };
+  if(op==OP_OPEN || op==OP_CLOSE){
+    sendFrame(OP_ACK, ack, 2);
+    if(op==OP_OPEN) openM(); else closeM();
+    cmdSeq = seq;
+    const byte p[2] = { seq, op };
+    sendFrame(OP_ACTION, p, 2);
+  } else if(op==OP_STATUS){
+    sendFrame(OP_ACK, ack, 2);
+    const byte p[1] = { (byte)(opened ? 1 : 0) };
+    sendFrame(OP_STATE, p, 1);
+  } else {
+    ack[1]=ACK_UNKNOWN;
+    sendFrame(OP_ACK, ack, 2);
+  }
 }
 
 void openM(){  digitalWrite(IN1,HIGH); digitalWrite(IN2,LOW);  st=1; tStart=millis(); }
@@ -52,5 +172,5 @@ void stopM(){  digitalWrite(IN1,LOW);  digitalWrite(IN2,LOW);  st=0; }
 
 void printStatus(Stream& io){
   io.print("STATE : ");
-  io.println(state);
+  io.println(stateName());
 }
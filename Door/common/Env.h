@@ -0,0 +1,15 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+
+// 설정값 읽기(환경변수 우선, 없으면 기본값)
+inline QString envOr(const char* key, const QString& fallback = QString()) {
+    const QByteArray v = qgetenv(key);
+    return v.isEmpty() ? fallback : QString::fromUtf8(v);
+}
+
+inline int envIntOr(const char* key, int fallback) {
+    bool ok = false;
+    const int v = qEnvironmentVariableIntValue(key, &ok);
+    return ok ? v : fallback;
+}
@@ -0,0 +1,176 @@
+#include "FaceDetector.h"
+#include "Env.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// cv::FaceDetectorYN은 OpenCV 4.5.4부터 제공
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 4)))
+#define HAS_FACE_DETECTOR_YN 1
+#else
+#define HAS_FACE_DETECTOR_YN 0
+#endif
+
+// ---------- 경로 탐색 ----------
+QString findModelLocal(const QString& fileName, const QString& systemSubdir) {
+    QStringList candidates;
+    // 실행 파일 폴더, 현재 작업 폴더
+    candidates << QDir(QCoreApplication::applicationDirPath()).filePath(fileName);
+    candidates << QDir::current().filePath(fileName);
+    // 우분투 기본 경로
+    if (!systemSubdir.isEmpty())
+        candidates << QString("/usr/share/opencv4/%1/%2").arg(systemSubdir, fileName);
+
+    for (const auto& p : candidates)
+        if (QFile::exists(p))
+            return p;
+    return QString();
+}
+
+// ---------- 공통: 지연시간 기록 ----------
+std::vector<cv::Rect> FaceDetector::detect(const cv::Mat& image, const cv::Size& minSize) {
+    if (image.empty() || !ready())
+        return {};
+
+    QElapsedTimer clock;
+    clock.start();
+    std::vector<cv::Rect> faces = detectImpl(image, minSize);
+    last = clock.nsecsElapsed() / 1e6;
+    totalMs += last;
+    runs++;
+    return faces;
+}
+
+namespace {
+
+// ---------- Haar / LBP cascade ----------
+class CascadeDetector : public FaceDetector {
+public:
+    CascadeDetector(const QString& kind, const QStringList& files, const QString& subdir)
+        : kind(kind) {
+        for (const auto& f : files) {
+            path = findModelLocal(f, subdir);
+            if (!path.isEmpty() && casc.load(path.toStdString()))
+                break;
+        }
+    }
+
+    QString name() const override { return kind; }
+    bool ready() const override { return !casc.empty(); }
+
+protected:
+    std::vector<cv::Rect> detectImpl(const cv::Mat& image, const cv::Size& minSize) override {
+        cv::Mat gray, eq; // 입력 영상은 건드리지 않음(추적기/ROI가 재사용)
+        if (image.channels() == 3)
+            cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        else
+            gray = image;
+        cv::equalizeHist(gray, eq);
+
+        std::vector<cv::Rect> faces;
+        casc.detectMultiScale(eq, faces, 1.1, 3, 0, minSize);
+        return faces;
+    }
+
+private:
+    QString kind;
+    QString path;
+    cv::CascadeClassifier casc;
+};
+
+// ---------- YuNet (CPU DNN) ----------
+class YuNetDetector : public FaceDetector {
+public:
+    YuNetDetector() {
+#if HAS_FACE_DETECTOR_YN
+        QString path = envOr("YUNET_MODEL");
+        if (path.isEmpty())
+            path = findModelLocal("face_detection_yunet_2023mar.onnx");
+        if (path.isEmpty())
+            path = findModelLocal("face_detection_yunet_2022mar.onnx");
+        if (path.isEmpty())
+            return;
+        try {
+            net = cv::FaceDetectorYN::create(path.toStdString(), "", cv::Size(320, 320), 0.8f, 0.3f, 20);
+        } catch (const cv::Exception& e) {
+            qWarning() << "[FaceDetector] YuNet load failed:" << e.what();
+            net.release();
+        }
+#endif
+    }
+
+    QString name() const override { return "yunet"; }
+#if HAS_FACE_DETECTOR_YN
+    bool ready() const override { return !net.empty(); }
+#else
+    bool ready() const override { return false; }
+#endif
+    bool needsColor() const override { return true; }
+
+protected:
+    std::vector<cv::Rect> detectImpl(const cv::Mat& image, const cv::Size& minSize) override {
+        std::vector<cv::Rect> faces;
+#if HAS_FACE_DETECTOR_YN
+        cv::Mat bgr;
+        if (image.channels() == 1)
+            cv::cvtColor(image, bgr, cv::COLOR_GRAY2BGR);
+        else
+            bgr = image;
+
+        if (bgr.size() != inputSize) {
+            inputSize = bgr.size();
+            net->setInputSize(inputSize);
+        }
+        cv::Mat out; // N x 15 (x, y, w, h, 랜드마크 10개, score)
+        net->detect(bgr, out);
+
+        const cv::Rect bounds(0, 0, bgr.cols, bgr.rows);
+        for (int i = 0; i < out.rows; ++i) {
+            cv::Rect r(cvRound(out.at<float>(i, 0)), cvRound(out.at<float>(i, 1)),
+                       cvRound(out.at<float>(i, 2)), cvRound(out.at<float>(i, 3)));
+            r &= bounds;
+            if (r.width >= minSize.width && r.height >= minSize.height)
+                faces.push_back(r);
+        }
+#else
+        Q_UNUSED(image);
+        Q_UNUSED(minSize);
+#endif
+        return faces;
+    }
+
+private:
+#if HAS_FACE_DETECTOR_YN
+    cv::Ptr<cv::FaceDetectorYN> net;
+    cv::Size inputSize;
+#endif
+};
+
+std::unique_ptr<FaceDetector> makeDetector(const QString& kind) {
+    if (kind == "lbp")
+        return std::make_unique<CascadeDetector>("lbp",
+            QStringList{"lbpcascade_frontalface_improved.xml", "lbpcascade_frontalface.xml"}, "lbpcascades");
+    if (kind == "yunet")
+        return std::make_unique<YuNetDetector>();
+    return std::make_unique<CascadeDetector>("haar",
+        QStringList{"haarcascade_frontalface_default.xml"}, "haarcascades");
+}
+
+} // namespace
+
+QStringList faceDetectorKinds() {
+    return {"haar", "lbp", "yunet"};
+}
+
+std::unique_ptr<FaceDetector> createFaceDetector(const QString& kind) {
+    const QString want = (kind.isEmpty() ? envOr("FACE_DETECTOR", "haar") : kind).trimmed().toLower();
+
+    std::unique_ptr<FaceDetector> det = makeDetector(want);
+    if (!det->ready() && want != "haar") {
+        qWarning() << "[FaceDetector]" << want << "not available, falling back to haar";
+        det = makeDetector("haar");
+    }
+    return det;
+}
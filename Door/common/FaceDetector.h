@@ -0,0 +1,44 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ---------- 얼굴 검출기 공통 인터페이스 (enroll / recognize 공용) ----------
+// 백엔드: haar(기본, Haar cascade), lbp(LBP cascade, 더 빠름), yunet(cv::FaceDetectorYN, CPU DNN)
+// 선택: 환경변수 FACE_DETECTOR=haar|lbp|yunet (준비 실패 시 haar로 폴백)
+class FaceDetector {
+public:
+    virtual ~FaceDetector() = default;
+
+    virtual QString name() const = 0;
+    virtual bool ready() const = 0;
+    // true면 컬러(BGR) 입력이 유리 (gray를 넘기면 내부에서 변환)
+    virtual bool needsColor() const { return false; }
+
+    // 얼굴 검출 + 지연시간 기록. image는 BGR 또는 gray, minSize는 image 기준 픽셀
+    std::vector<cv::Rect> detect(const cv::Mat& image, const cv::Size& minSize);
+
+    // 프레임당 검출 지연시간(ms)
+    double lastMs() const { return last; }
+    double avgMs() const { return runs ? totalMs / runs : 0.0; }
+    quint64 runCount() const { return runs; }
+
+protected:
+    virtual std::vector<cv::Rect> detectImpl(const cv::Mat& image, const cv::Size& minSize) = 0;
+
+private:
+    double last = 0.0;
+    double totalMs = 0.0;
+    quint64 runs = 0;
+};
+
+// 이름으로 검출기 생성 ("" 이면 FACE_DETECTOR 환경변수, 그것도 없으면 haar)
+std::unique_ptr<FaceDetector> createFaceDetector(const QString& kind = QString());
+
+// 지원 백엔드 목록
+QStringList faceDetectorKinds();
+
+// 모델 파일 탐색: 실행 파일 폴더 → 현재 폴더 → 시스템 경로(/usr/share/opencv4/<subdir>)
+QString findModelLocal(const QString& fileName, const QString& systemSubdir = QString());
@@ -0,0 +1,61 @@
+#include "FaceTemplate.h"
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <opencv2/imgproc.hpp>
+#include <cstring>
+
+cv::Mat makeFaceTemplate(const cv::Mat& face) {
+    if (face.empty())
+        return cv::Mat();
+    cv::Mat gray;
+    if (face.channels() == 3)
+        cv::cvtColor(face, gray, cv::COLOR_BGR2GRAY);
+    else if (face.channels() == 4)
+        cv::cvtColor(face, gray, cv::COLOR_BGRA2GRAY);
+    else
+        gray = face;
+
+    if (gray.rows == kFaceTemplateSide && gray.cols == kFaceTemplateSide)
+        return gray.isContinuous() ? gray : gray.clone();
+    cv::Mat out;
+    cv::resize(gray, out, cv::Size(kFaceTemplateSide, kFaceTemplateSide), 0, 0, cv::INTER_AREA);
+    return out;
+}
+
+QByteArray encodeFaceTemplate(const cv::Mat& gray128) {
+    if (gray128.rows != kFaceTemplateSide || gray128.cols != kFaceTemplateSide || gray128.type() != CV_8UC1)
+        return QByteArray();
+    const cv::Mat m = gray128.isContinuous() ? gray128 : gray128.clone();
+    return QByteArray(reinterpret_cast<const char*>(m.data), kFaceTemplateBytes);
+}
+
+bool decodeFaceTemplate(const QByteArray& blob, cv::Mat& outGray128) {
+    if (blob.size() != kFaceTemplateBytes)
+        return false;
+    // 컬럼 값(QByteArray)은 곧 해제되므로 복사본을 가짐
+    outGray128.create(kFaceTemplateSide, kFaceTemplateSide, CV_8UC1);
+    std::memcpy(outGray128.data, blob.constData(), kFaceTemplateBytes);
+    return true;
+}
+
+bool hasFaceTemplateColumns(const QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT COUNT(*) FROM information_schema.COLUMNS "
+                "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'face_images' "
+                "AND COLUMN_NAME IN ('face_template', 'template_version')") || !q.next())
+        return false;
+    return q.value(0).toInt() == 2;
+}
+
+bool ensureFaceTemplateColumns(const QSqlDatabase& db, QString* error) {
+    if (hasFaceTemplateColumns(db))
+        return true;
+    QSqlQuery q(db);
+    if (!q.exec("ALTER TABLE face_images "
+                "ADD COLUMN face_template MEDIUMBLOB NULL, "
+                "ADD COLUMN template_version SMALLINT NULL")) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    return true;
+}
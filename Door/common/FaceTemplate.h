@@ -0,0 +1,24 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include <opencv2/core.hpp>
+
+// ---------- 전처리된 얼굴 템플릿 (enroll / recognize 공용) ----------
+// face_images.face_template    : gray 128x128 원시 바이트(16384B, 행 우선)
+// face_images.template_version : 형식 버전. recognize는 버전이 같을 때만 그대로 쓰고, 다르면 face_data(PNG)를 디코딩
+// 전처리(흑백 변환/리사이즈 방식)를 바꾸면 kFaceTemplateVersion을 올리고 recognize --backfill-templates 실행
+constexpr int kFaceTemplateVersion = 1;
+constexpr int kFaceTemplateSide = 128;
+constexpr int kFaceTemplateBytes = kFaceTemplateSide * kFaceTemplateSide;
+
+// 얼굴 영상(BGR 또는 gray, 임의 크기) → 템플릿(CV_8UC1 128x128, 축소는 INTER_AREA)
+cv::Mat makeFaceTemplate(const cv::Mat& face);
+
+// 템플릿 ↔ 컬럼 값
+QByteArray encodeFaceTemplate(const cv::Mat& gray128);
+bool decodeFaceTemplate(const QByteArray& blob, cv::Mat& outGray128); // 크기가 다르면 false
+
+// 템플릿 컬럼 확인/추가 (ALTER TABLE 권한 필요, 이미 있으면 그대로 true)
+bool hasFaceTemplateColumns(const QSqlDatabase& db);
+bool ensureFaceTemplateColumns(const QSqlDatabase& db, QString* error = nullptr);
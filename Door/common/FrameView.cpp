@@ -0,0 +1,44 @@
+#include "FrameView.h"
+#include "Env.h"
+#include <QFontDatabase>
+#include <QLabel>
+#include <QStringList>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+bool matToRgbImage(const cv::Mat& mat, QImage& dst) {
+    if (mat.empty() || mat.depth() != CV_8U || (mat.channels() != 1 && mat.channels() != 3))
+        return false;
+    if (dst.width() != mat.cols || dst.height() != mat.rows || dst.format() != QImage::Format_RGB888)
+        dst = QImage(mat.cols, mat.rows, QImage::Format_RGB888);
+
+    // QImage 버퍼를 Mat으로 감싸 cvtColor가 바로 기록 (크기/형식이 같으면 재할당 없음)
+    cv::Mat view(dst.height(), dst.width(), CV_8UC3, dst.bits(), dst.bytesPerLine());
+    cv::cvtColor(mat, view, mat.channels() == 3 ? cv::COLOR_BGR2RGB : cv::COLOR_GRAY2RGB);
+    return true;
+}
+
+const QFont& overlayFont() {
+    static const QFont font = [] {
+        QFont f;
+        const QStringList families = QFontDatabase::families();
+        for (const char* fam : {"Noto Sans CJK KR", "Noto Sans KR", "NanumGothic", "Nanum Gothic"}) {
+            if (families.contains(fam)) {
+                f.setFamily(fam);
+                break;
+            }
+        }
+        f.setPointSize(14);
+        return f;
+    }();
+    return font;
+}
+
+void setTextIfChanged(QLabel* label, const QString& text) {
+    if (label && label->text() != text)
+        label->setText(text);
+}
+
+int displayIntervalMs() {
+    return 1000 / std::clamp(envIntOr("DISPLAY_FPS", 15), 1, 60);
+}
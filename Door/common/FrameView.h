@@ -0,0 +1,26 @@
+#pragma once
+#include <QFont>
+#include <QImage>
+#include <QString>
+#include <opencv2/core.hpp>
+
+class QLabel;
+
+// ---------- 미리보기 출력 (enroll / recognize 공용) ----------
+// 화면 갱신이 프레임마다 하던 일을 줄임
+// - Mat → QImage: 재사용하는 RGB888 버퍼에 바로 변환 (중간 RGB Mat, 깊은 복사 없음)
+// - 오버레이 폰트: 후보 검색(QFontDatabase)은 처음 한 번만
+// - QLabel 문자열: 바뀐 경우에만 갱신
+// - 화면 갱신은 DISPLAY_FPS(기본 15)로 제한 — 인식 속도와 분리
+
+// mat(8bit BGR/gray) → dst(RGB888). 크기가 같으면 dst 버퍼를 그대로 씀
+// dst를 다른 QImage와 공유 중이면 쓰기 전에 Qt가 분리(복사)하므로 dst 자체는 오래 들고 있지 말 것
+bool matToRgbImage(const cv::Mat& mat, QImage& dst);
+
+// 오버레이 폰트: Noto → Nanum → 시스템 기본, 14pt (QApplication 생성 후 호출)
+const QFont& overlayFont();
+
+void setTextIfChanged(QLabel* label, const QString& text);
+
+// 화면 갱신 최소 간격(ms) = 1000 / DISPLAY_FPS
+int displayIntervalMs();
@@ -1,5 +1,7 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
+#include "FaceTemplate.h"
+#include "FrameView.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QDir>
@@ -9,34 +11,7 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 
-// ---------- 경로 탐색: Haar Cascade ----------
-static QString findCascadeLocal() {
-    QStringList candidates;
-    // 실행 파일 폴더, 현재 작업 폴더
-    candidates << QDir(QCoreApplication::applicationDirPath()).filePath("haarcascade_frontalface_default.xml");
-    candidates << QDir::current().filePath("haarcascade_frontalface_default.xml");
-    // 우분투 기본 경로
-    candidates << "/usr/share/opencv4/haarcascades/haarcascade_frontalface_default.xml";
-    for (const auto& p : candidates) if (QFile::exists(p)) return p;
-    return QString();
-}
-
 // ---------- 변환/유틸 ----------
-QImage MainWindow::matToQImage(const cv::Mat& mat) {
-    if (mat.empty()) return QImage();
-    if (mat.type() == CV_8UC1) {
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_Grayscale8).copy();
-    } else if (mat.type() == CV_8UC3) {
-        cv::Mat rgb; cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        return QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
-    } else {
-        cv::Mat gray;
-        if (mat.channels() == 3) cv::cvtColor(mat, gray, cv::COLOR_BGR2GRAY);
-        else mat.convertTo(gray, CV_8U);
-        return QImage(gray.data, gray.cols, gray.rows, gray.step, QImage::Format_Grayscale8).copy();
-    }
-}
-
 cv::Rect MainWindow::largestRect(const std::vector<cv::Rect>& rects) {
     int idx = -1; int areaMax = -1;
     for (int i=0;i<(int)rects.size();++i) {
@@ -45,27 +20,25 @@ cv::Rect MainWindow::largestRect(const std::vector<cv::Rect>& rects) {
     return (idx >= 0) ? rects[idx] : cv::Rect();
 }
 
+// 미리보기: 재사용 버퍼에 변환(FrameView.h) → 라벨 크기로 줄인 뒤 픽스맵 (미리보기라 FastTransformation)
 void MainWindow::showMatOn(QLabel* label, const cv::Mat& mat) {
     if (!label) return;
-    QImage img = matToQImage(mat);
-    if (img.isNull()) return;
-    label->setPixmap(QPixmap::fromImage(img)
-                         .scaled(label->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    if (!matToRgbImage(mat, previewImage)) return;
+    label->setPixmap(QPixmap::fromImage(previewImage.scaled(label->size(), Qt::KeepAspectRatio, Qt::FastTransformation)));
 }
 
-void MainWindow::ensureCascadeLoaded() {
-    if (!cascadePath.isEmpty() && !faceCasc.empty()) return;
-    cascadePath = findCascadeLocal();
-    if (!cascadePath.isEmpty()) faceCasc.load(cascadePath.toStdString());
+void MainWindow::ensureDetectorLoaded() {
+    if (detectorReady()) return;
+    detector = createFaceDetector(); // 경로 탐색/폴백은 공용 모듈에서 처리
 }
 
 void MainWindow::setStatus(const QString& s)  {
-    if (ui->lblStatus)  ui->lblStatus->setText(s);
+    setTextIfChanged(ui->lblStatus, s);
     // statusBar()->showMessage(s); // 중복 표시 원치 않으면 비활성
 }
 
 void MainWindow::setMessage(const QString& s) {
-    if (ui->lblMessage) ui->lblMessage->setText(s);
+    setTextIfChanged(ui->lblMessage, s);
 }
 
 // ---------- 카메라 ----------
@@ -77,12 +50,14 @@ void MainWindow::startCamera() {
             return;
         }
     }
-    ensureCascadeLoaded();
-    setStatus((cascadePath.isEmpty() || faceCasc.empty())
+    ensureDetectorLoaded();
+    setStatus(!detectorReady()
                   ? "카메라 시작 (얼굴 인식 불가)"
-                  : "카메라 시작 (얼굴 인식 가능)");
+                  : QString("카메라 시작 (얼굴 인식 가능, 검출기: %1)").arg(detector->name()));
     connect(&timer, &QTimer::timeout, this, &MainWindow::onFrameTick, Qt::UniqueConnection);
-    timer.start(33); // ~30fps
+    timer.start(33); // ~30fps (캡처), 화면은 DISPLAY_FPS로만 갱신
+    displayClock.start();
+    renderClock.start();
 }
 
 void MainWindow::stopCamera() {
@@ -107,15 +82,33 @@ MainWindow::~MainWindow() {
     delete ui;
 }
 
-// ---------- DB INSERT (컬러 PNG 저장) ----------
+// ---------- DB INSERT (컬러 PNG + 전처리 템플릿 저장) ----------
 bool MainWindow::insertFacePng(int userId, const QString& userName, const cv::Mat& color128) {
     std::vector<uchar> buf;
     cv::imencode(".png", color128, buf);
     QByteArray ba(reinterpret_cast<const char*>(buf.data()), (int)buf.size());
 
     if (!db.open()) { setMessage("DB 연결 실패 (설정/환경 변수 확인)"); return false; }
+
+    // 처음 연결 시 템플릿 컬럼 확인/추가 (권한이 없으면 PNG만 저장)
+    if (!templateSchemaChecked) {
+        QString err;
+        templateColumns = ensureFaceTemplateColumns(db.database(), &err);
+        if (!templateColumns)
+            qWarning() << "[Enroll] face_template column unavailable, storing PNG only:" << err;
+        templateSchemaChecked = true;
+    }
+
     QSqlQuery q(db.database());
-    q.prepare("INSERT INTO face_images (user_id, user_name, face_data) VALUES (:uid, :uname, :data)");
+    if (templateColumns) {
+        // recognize가 PNG 디코딩 없이 바로 쓰는 gray 128x128 (버전이 다르면 recognize가 PNG로 폴백)
+        q.prepare("INSERT INTO face_images (user_id, user_name, face_data, face_template, template_version) "
+                  "VALUES (:uid, :uname, :data, :tmpl, :ver)");
+        q.bindValue(":tmpl", encodeFaceTemplate(makeFaceTemplate(color128)));
+        q.bindValue(":ver",  kFaceTemplateVersion);
+    } else {
+        q.prepare("INSERT INTO face_images (user_id, user_name, face_data) VALUES (:uid, :uname, :data)");
+    }
     q.bindValue(":uid",   userId);
     q.bindValue(":uname", userName);
     q.bindValue(":data",  ba);
@@ -151,20 +144,32 @@ void MainWindow::onFrameTick() {
     cap >> frame;
     if (frame.empty()) return;
 
-    // 라이브 프리뷰 + 얼굴 박스(표시용)
-    ensureCascadeLoaded();
-    cv::Rect faceR;
-    if (!cascadePath.isEmpty() && !faceCasc.empty()) {
-        cv::Mat gray;
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::equalizeHist(gray, gray);
-        std::vector<cv::Rect> faces;
-        faceCasc.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(60,60));
-        for (const auto& r : faces)
-            cv::rectangle(frame, r, cv::Scalar(0,255,0), 2);
-        faceR = largestRect(faces);
+    // 라이브 프리뷰 + 얼굴 박스(표시용) — 화면 갱신 주기(DISPLAY_FPS)가 됐을 때만
+    ensureDetectorLoaded();
+    if (displayClock.elapsed() >= displayMs) {
+        displayClock.restart();
+        if (detectorReady()) {
+            // gray 변환/평활화는 검출기 백엔드가 필요에 따라 수행
+            std::vector<cv::Rect> faces = detector->detect(frame, cv::Size(60,60));
+            for (const auto& r : faces)
+                cv::rectangle(frame, r, cv::Scalar(0,255,0), 2);
+        }
+        QElapsedTimer clock;
+        clock.start();
+        showMatOn(ui->videoLabel, frame);
+        renderSum += clock.nsecsElapsed() / 1e6;
+        renders++;
+
+        // 그리기 비용 (5초마다)
+        if (renderClock.elapsed() >= 5000) {
+            qDebug().noquote() << QString("[Enroll] render %1 ms (%2 fps)")
+                                      .arg(renderSum / renders, 0, 'f', 1)
+                                      .arg(renders * 1000.0 / renderClock.elapsed(), 0, 'f', 1);
+            renders = 0;
+            renderSum = 0.0;
+            renderClock.restart();
+        }
     }
-    showMatOn(ui->videoLabel, frame);
 
     // 캡처 중이 아니라면 저장X
     // 또한 일정 간격으로 저장하기 위한 안전장치
@@ -175,14 +180,9 @@ void MainWindow::onFrameTick() {
     cap >> shot;
     if (shot.empty()) return;
     // 저장용 컬러 ROI
-    cv::Mat gray;
-    cv::cvtColor(shot, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
     cv::Rect r;
-    if (!cascadePath.isEmpty() && !faceCasc.empty()) {
-        std::vector<cv::Rect> faces;
-        faceCasc.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(60,60));
-        r = largestRect(faces);
+    if (detectorReady()) {
+        r = largestRect(detector->detect(shot, cv::Size(60,60)));
     }
     // 사이즈 변경(128x128)
     cv::Mat color128;
@@ -9,6 +9,9 @@
 #include <QSqlError>
 #include <QDateTime>
 #include <QDebug>
+#include <memory>
+#include "FaceDetector.h"
+#include "FrameView.h"
 
 class DbManager {
 public:
@@ -79,6 +82,14 @@ private:
     QTimer timer;
     cv::VideoCapture cap;
 
+    // 미리보기 (변환 버퍼 재사용, DISPLAY_FPS로 갱신 제한)
+    QImage previewImage;
+    QElapsedTimer displayClock;
+    int displayMs = displayIntervalMs();
+    QElapsedTimer renderClock; // 그리기 시간 보고 구간
+    double renderSum = 0.0;
+    int renders = 0;
+
     // 캡처 세션 상태
     bool capturing = false;
     int  targetCount = 15;        // 한 번 등록 시 저장할 장수
@@ -88,15 +99,18 @@ private:
     int currentUserId = -1;
     QString currentUserName;
 
-    // 얼굴 검출
-    cv::CascadeClassifier faceCasc;
-    QString cascadePath;
+    // face_template 컬럼 (첫 저장 때 확인/추가)
+    bool templateSchemaChecked = false;
+    bool templateColumns = false;
+
+    // 얼굴 검출 (FACE_DETECTOR=haar|lbp|yunet)
+    std::unique_ptr<FaceDetector> detector;
 
     // helpers
     void showMatOn(QLabel* label, const cv::Mat& mat);
-    static QImage matToQImage(const cv::Mat& mat);
     static cv::Rect largestRect(const std::vector<cv::Rect>& rects);
-    void ensureCascadeLoaded();
+    void ensureDetectorLoaded();
+    bool detectorReady() const { return detector && detector->ready(); }
     bool insertFacePng(int userId, const QString& userName, const cv::Mat& color128);
     void startCamera();  // 앱 시작 시 자동 실행
     void stopCamera();
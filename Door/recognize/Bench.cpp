@@ -0,0 +1,562 @@
+#include "Bench.h"
+#include "NnMatcher.h"
+#include "LbphModel.h"
+#include "FaceRecognizer.h"
+#include "DbManager.h"
+#include "Env.h"
+#include "GalleryLoader.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QThread>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if __has_include(<opencv2/face.hpp>)
+#include <opencv2/face.hpp>
+#define HAS_OPENCV_FACE 1
+#else
+#define HAS_OPENCV_FACE 0
+#endif
+
+namespace {
+
+// 기존 fallback predictLabel()과 같은 방식(비교마다 임시 Mat 2개 할당)
+int legacyNearest(const std::vector<cv::Mat>& gallery, const cv::Mat& q) {
+    double best = 1e18;
+    int bestIdx = -1;
+    for (size_t i = 0; i < gallery.size(); ++i) {
+        cv::Mat diff;
+        cv::absdiff(q, gallery[i], diff);
+        diff.convertTo(diff, CV_32F);
+        const double dist = std::sqrt(cv::sum(diff.mul(diff))[0]);
+        if (dist < best) {
+            best = dist;
+            bestIdx = (int)i;
+        }
+    }
+    return bestIdx;
+}
+
+// 갤러리 샘플 하나에 잡음을 더한 질의 (실제 사용처럼 가까운 샘플이 존재)
+std::vector<cv::Mat> makeQueries(const std::vector<cv::Mat>& gallery, int count, cv::RNG& rng) {
+    std::vector<cv::Mat> qs;
+    for (int i = 0; i < count; ++i) {
+        cv::Mat noise(128, 128, CV_16S);
+        rng.fill(noise, cv::RNG::NORMAL, 0, 12);
+        cv::Mat q;
+        gallery[rng.uniform(0, (int)gallery.size())].convertTo(q, CV_16S);
+        q += noise;
+        q.convertTo(q, CV_8U);
+        qs.push_back(q);
+    }
+    return qs;
+}
+
+template <typename Fn>
+double msPerQuery(const std::vector<cv::Mat>& qs, Fn fn) {
+    QElapsedTimer clock;
+    clock.start();
+    for (const auto& q : qs)
+        fn(q);
+    return clock.nsecsElapsed() / 1e6 / qs.size();
+}
+
+int benchNn() {
+    const int sizes[] = {100, 500, 1000, 2000, 5000};
+    cv::RNG rng(12345);
+
+    qDebug().noquote() << QString("[Bench nn] kernel=%1 threads=%2").arg(NnMatcher::kernelName()).arg(cv::getNumThreads());
+    qDebug().noquote() << "  gallery |  legacy ms | scalar ms |   simd ms | simd+par ms | speedup";
+
+    for (int n : sizes) {
+        std::vector<cv::Mat> gallery;
+        NnMatcher matcher;
+        matcher.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            cv::Mat img(128, 128, CV_8U);
+            rng.fill(img, cv::RNG::UNIFORM, 0, 256);
+            cv::GaussianBlur(img, img, cv::Size(9, 9), 3); // 얼굴처럼 부드러운 영상
+            gallery.push_back(img);
+            matcher.add(img, i);
+        }
+        const std::vector<cv::Mat> qs = makeQueries(gallery, 20, rng);
+
+        int label = -1;
+        double dist = 0.0;
+        const double legacy = msPerQuery(qs, [&](const cv::Mat& q) { legacyNearest(gallery, q); });
+
+        matcher.setParallel(false);
+        matcher.setKernel(NnMatcher::Kernel::Scalar);
+        const double scalar = msPerQuery(qs, [&](const cv::Mat& q) { matcher.match(q, label, dist); });
+        matcher.setKernel(NnMatcher::Kernel::Auto);
+        const double simd = msPerQuery(qs, [&](const cv::Mat& q) { matcher.match(q, label, dist); });
+        matcher.setParallel(true);
+        const double par = msPerQuery(qs, [&](const cv::Mat& q) { matcher.match(q, label, dist); });
+
+        // 결과 일치 확인(기존 루프와 같은 샘플을 골라야 함)
+        int mismatch = 0;
+        for (const auto& q : qs) {
+            matcher.match(q, label, dist);
+            if (label != legacyNearest(gallery, q)) mismatch++;
+        }
+
+        qDebug().noquote() << QString("  %1 | %2 | %3 | %4 | %5 | x%6%7")
+                                  .arg(n, 7)
+                                  .arg(legacy, 10, 'f', 3).arg(scalar, 9, 'f', 3)
+                                  .arg(simd, 9, 'f', 3).arg(par, 11, 'f', 3)
+                                  .arg(legacy / std::max(par, 1e-6), 0, 'f', 1)
+                                  .arg(mismatch ? QString("  (MISMATCH %1)").arg(mismatch) : QString());
+    }
+    return 0;
+}
+
+// 얼굴처럼 부드러운 랜덤 영상 갤러리 (라벨 = 인덱스 / 5 : 사람당 5장)
+void makeGallery(int n, cv::RNG& rng, std::vector<cv::Mat>& images, std::vector<int>& labels) {
+    images.clear();
+    labels.clear();
+    for (int i = 0; i < n; ++i) {
+        cv::Mat img(128, 128, CV_8U);
+        rng.fill(img, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(img, img, cv::Size(9, 9), 3);
+        images.push_back(img);
+        labels.push_back(i / 5);
+    }
+}
+
+template <typename Fn>
+double msOnce(Fn fn) {
+    QElapsedTimer clock;
+    clock.start();
+    fn();
+    return clock.nsecsElapsed() / 1e6;
+}
+
+int benchLbph() {
+    const int sizes[] = {100, 500, 1000, 2000};
+    cv::RNG rng(12345);
+    const int threads = cv::getNumThreads();
+
+    qDebug().noquote() << QString("[Bench lbph] kernel=%1 threads=%2 contrib=%3")
+                              .arg(LbphModel::kernelName()).arg(threads).arg(HAS_OPENCV_FACE ? "yes" : "no");
+    qDebug().noquote() << "  gallery | train 1T ms | train par ms | pred scalar | pred simd | simd+par | contrib train | contrib pred";
+
+    for (int n : sizes) {
+        std::vector<cv::Mat> images;
+        std::vector<int> labels;
+        makeGallery(n, rng, images, labels);
+        const std::vector<cv::Mat> qs = makeQueries(images, 20, rng);
+
+        LbphModel model;
+        cv::setNumThreads(1);
+        const double train1 = msOnce([&] { model.train(images, labels); });
+        cv::setNumThreads(threads);
+        const double trainPar = msOnce([&] { model.train(images, labels); });
+
+        int label = -1;
+        double dist = 0.0;
+        model.setParallel(false);
+        model.setKernel(LbphModel::Kernel::Scalar);
+        const double scalar = msPerQuery(qs, [&](const cv::Mat& q) { model.predict(q, label, dist); });
+        model.setKernel(LbphModel::Kernel::Auto);
+        const double simd = msPerQuery(qs, [&](const cv::Mat& q) { model.predict(q, label, dist); });
+        model.setParallel(true);
+        const double par = msPerQuery(qs, [&](const cv::Mat& q) { model.predict(q, label, dist); });
+
+        QString contrib = "            - |            -";
+#if HAS_OPENCV_FACE
+        // contrib LBPH와 시간/결과 비교 (같은 파라미터 create(1, 8, 8, 8))
+        cv::Ptr<cv::face::LBPHFaceRecognizer> ref = cv::face::LBPHFaceRecognizer::create(1, 8, 8, 8, DBL_MAX);
+        const double refTrain = msOnce([&] { ref->train(images, labels); });
+        int refLabel = -1;
+        double refDist = 0.0;
+        const double refPred = msPerQuery(qs, [&](const cv::Mat& q) { ref->predict(q, refLabel, refDist); });
+        int mismatch = 0;
+        double maxDiff = 0.0;
+        for (const auto& q : qs) {
+            model.predict(q, label, dist);
+            ref->predict(q, refLabel, refDist);
+            if (label != refLabel) mismatch++;
+            maxDiff = std::max(maxDiff, std::abs(dist - refDist));
+        }
+        contrib = QString("%1 | %2  (label mismatch %3, max |Δdist| %4)")
+                      .arg(refTrain, 13, 'f', 1).arg(refPred, 12, 'f', 3)
+                      .arg(mismatch).arg(maxDiff, 0, 'g', 3);
+#endif
+
+        qDebug().noquote() << QString("  %1 | %2 | %3 | %4 | %5 | %6 | %7")
+                                  .arg(n, 7)
+                                  .arg(train1, 11, 'f', 1).arg(trainPar, 12, 'f', 1)
+                                  .arg(scalar, 11, 'f', 3).arg(simd, 9, 'f', 3).arg(par, 8, 'f', 3)
+                                  .arg(contrib);
+    }
+    return 0;
+}
+
+// 갤러리 샘플을 조금 변형한 질의(1px 이동 + 밝기 변화 + 잡음)와 정답 라벨
+void makeLabeledQueries(const std::vector<cv::Mat>& images, const std::vector<int>& labels, int count, cv::RNG& rng,
+                        std::vector<cv::Mat>& queries, std::vector<int>& truth) {
+    queries.clear();
+    truth.clear();
+    for (int i = 0; i < count; ++i) {
+        const int src = rng.uniform(0, (int)images.size());
+        const cv::Mat shift = (cv::Mat_<double>(2, 3) << 1, 0, rng.uniform(-1, 2), 0, 1, rng.uniform(-1, 2));
+        cv::Mat moved;
+        cv::warpAffine(images[src], moved, shift, images[src].size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+        cv::Mat noise(moved.size(), CV_16S);
+        rng.fill(noise, cv::RNG::NORMAL, 0, 8);
+        cv::Mat q;
+        moved.convertTo(q, CV_16S, rng.uniform(0.9, 1.1));
+        q += noise;
+        q.convertTo(q, CV_8U);
+        queries.push_back(q);
+        truth.push_back(labels[src]);
+    }
+}
+
+// 정렬된 거리에서 수락 비율 rate(0~1)를 유지하는 임계값 (그 분위수의 거리)
+double thresholdForAcceptRate(std::vector<double> dists, double rate) {
+    if (dists.empty() || rate <= 0.0)
+        return 0.0;
+    std::sort(dists.begin(), dists.end());
+    const size_t k = std::min(dists.size(), (size_t)std::ceil(rate * dists.size()));
+    return dists[k - 1];
+}
+
+// compact 임계값 보정: f32 기본 임계값(lbph 백엔드 기본값)의 수락 비율과 같아지는 거리를 저장 형식마다 출력
+// → 실제 갤러리로 돌린 값을 RECOGNIZER_THRESHOLD(lbph-compact)에 사용
+int benchLbphCompact() {
+    const int sizes[] = {500, 2000};
+    const LbphModel::Storage storages[] = {LbphModel::Storage::Float32, LbphModel::Storage::Uniform16,
+                                           LbphModel::Storage::Uniform8};
+    cv::RNG rng(12345);
+
+    qDebug().noquote() << QString("[Bench lbph-compact] kernel=%1 threads=%2").arg(LbphModel::kernelName()).arg(cv::getNumThreads());
+    const double fullThresh = createRecognizerBackend("lbph")->threshold();
+    qDebug().noquote() << QString("[Bench lbph-compact] threshold = f32 accept rate @ %1").arg(fullThresh, 0, 'f', 1);
+    qDebug().noquote() << "  gallery | storage | KB/sample | total MB | train ms | pred ms | accuracy | Δ vs f32 | agree f32 | accept | threshold";
+
+    for (int n : sizes) {
+        std::vector<cv::Mat> images;
+        std::vector<int> labels;
+        makeGallery(n, rng, images, labels);
+        std::vector<cv::Mat> qs;
+        std::vector<int> truth;
+        makeLabeledQueries(images, labels, 200, rng, qs, truth);
+
+        std::vector<int> fullPred;
+        double fullAcc = 0.0;
+        double fullAccept = 0.0;
+        for (LbphModel::Storage st : storages) {
+            LbphModel model(st);
+            const double trainMs = msOnce([&] { model.train(images, labels); });
+
+            std::vector<int> pred(qs.size(), -1);
+            std::vector<double> dists(qs.size(), 0.0);
+            size_t qi = 0;
+            const double predMs = msPerQuery(qs, [&](const cv::Mat& q) {
+                model.predict(q, pred[qi], dists[qi]);
+                qi++;
+            });
+
+            int correct = 0, agree = 0;
+            for (size_t i = 0; i < qs.size(); ++i) {
+                if (pred[i] == truth[i]) correct++;
+                if (!fullPred.empty() && pred[i] == fullPred[i]) agree++;
+            }
+            const double acc = 100.0 * correct / qs.size();
+            if (st == LbphModel::Storage::Float32) {
+                fullPred = pred;
+                fullAcc = acc;
+                agree = (int)qs.size();
+                fullAccept = std::count_if(dists.begin(), dists.end(),
+                                           [&](double d) { return d <= fullThresh; }) / (double)qs.size();
+            }
+            // f32는 기본 임계값 그대로, compact는 같은 수락 비율이 되는 거리
+            const double thresh = st == LbphModel::Storage::Float32 ? fullThresh
+                                                                     : thresholdForAcceptRate(dists, fullAccept);
+
+            qDebug().noquote() << QString("  %1 | %2 | %3 | %4 | %5 | %6 | %7% | %8%p | %9% | %10% | %11")
+                                      .arg(n, 7).arg(LbphModel::storageName(st), 7)
+                                      .arg(model.bytesPerSample() / 1024.0, 9, 'f', 1)
+                                      .arg(model.bytesPerSample() * (double)n / (1024.0 * 1024.0), 8, 'f', 1)
+                                      .arg(trainMs, 8, 'f', 1).arg(predMs, 7, 'f', 3)
+                                      .arg(acc, 7, 'f', 1).arg(acc - fullAcc, 7, 'f', 1)
+                                      .arg(100.0 * agree / qs.size(), 8, 'f', 1)
+                                      .arg(100.0 * fullAccept, 5, 'f', 1).arg(thresh, 9, 'f', 2);
+        }
+    }
+    return 0;
+}
+
+// ---------- 갤러리 적재 ----------
+
+// 최대 RSS(VmHWM) 초기화 — 리눅스 4.0+ (/proc/self/clear_refs에 5)
+void resetPeakRss() {
+    QFile f("/proc/self/clear_refs");
+    if (f.open(QIODevice::WriteOnly))
+        f.write("5");
+}
+
+// /proc/self/status의 항목(kB). 없으면 -1
+long procStatusKb(const char* key) {
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly))
+        return -1;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (line.startsWith(key))
+            return line.mid((int)std::strlen(key)).trimmed().split(' ').first().toLong();
+    }
+    return -1;
+}
+
+// 이전 loadGalleryFromDb()와 같은 방식: 결과 전체 버퍼링 + 복사해서 컬러 디코딩 → gray → resize, 한 스레드
+bool legacyDecode(const QByteArray& png, cv::Mat& outGray128) {
+    std::vector<uchar> buf(png.begin(), png.end());
+    cv::Mat color = cv::imdecode(buf, cv::IMREAD_COLOR);
+    if (color.empty())
+        return false;
+    cv::Mat gray;
+    cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+    cv::resize(gray, outGray128, cv::Size(128, 128));
+    return true;
+}
+
+void legacyLoad(const QList<FaceBlob>& rows, Gallery& out) {
+    out.clear();
+    QHash<int, QSet<QString>> namesPerId;
+    for (const FaceBlob& b : rows)
+        namesPerId[b.userId].insert(b.userName);
+    for (auto it = namesPerId.cbegin(); it != namesPerId.cend(); ++it) {
+        if (it.value().size() > 1)
+            out.conflictIds.insert(it.key());
+    }
+    for (const FaceBlob& b : rows) {
+        cv::Mat gray;
+        if (legacyDecode(b.data, gray))
+            out.add(b.id, b.userId, b.userName, gray);
+    }
+}
+
+struct LoadRun {
+    double ms = 0.0;
+    long peakKb = 0; // 시작 시점 RSS 대비 최대 증가량
+    qint64 rows = 0;
+};
+
+template <typename Fn>
+LoadRun measureLoad(Fn fn) {
+    resetPeakRss();
+    const long base = procStatusKb("VmRSS:");
+    LoadRun run;
+    run.ms = msOnce([&] { run.rows = fn(); });
+    run.peakKb = procStatusKb("VmHWM:") - base;
+    return run;
+}
+
+void printLoad(const char* source, const char* path, const LoadRun& r) {
+    qDebug().noquote() << QString("  %1 | %2 | %3 | %4 | %5 | %6")
+                              .arg(source, 10).arg(path, 9).arg(r.rows, 6)
+                              .arg(r.ms, 9, 'f', 1).arg(r.rows * 1000.0 / std::max(r.ms, 1e-3), 8, 'f', 0)
+                              .arg(r.peakKb < 0 ? QString("      -") : QString::number(r.peakKb / 1024.0, 'f', 1).rightJustified(7));
+}
+
+// 두 갤러리 템플릿의 평균 |Δ픽셀| 최댓값 (디코딩 경로 차이 확인)
+double maxTemplateDiff(const Gallery& a, const Gallery& b) {
+    double worst = 0.0;
+    for (int i = 0; i < std::min(a.size(), b.size()); ++i)
+        worst = std::max(worst, cv::norm(a.images[i], b.images[i], cv::NORM_L1) / (128.0 * 128.0));
+    return worst;
+}
+
+int benchLoader() {
+    const int n = std::max(1, envIntOr("LOADER_BENCH_ROWS", 3000));
+    cv::RNG rng(12345);
+
+    qDebug().noquote() << QString("[Bench loader] rows=%1 threads=%2 window=%3 (LOADER_WINDOW)")
+                              .arg(n).arg(QThread::idealThreadCount())
+                              .arg(envIntOr("LOADER_WINDOW", QThread::idealThreadCount() * 8));
+    qDebug().noquote() << "      source |      path |   rows |   total ms |   rows/s | peak MB";
+
+    // 1. 합성 blob: 등록 앱과 같은 128x128 컬러 PNG, 카메라 원본 크기 JPEG
+    //    서로 다른 32장을 돌려 쓰고, 기존 경로는 드라이버처럼 전체를 복사해 버퍼링
+    struct Format { const char* name; const char* ext; int w, h; };
+    const Format formats[] = {{"png128", ".png", 128, 128}, {"jpeg640", ".jpg", 640, 480}};
+    for (const Format& fmt : formats) {
+        std::vector<QByteArray> pool;
+        for (int i = 0; i < 32; ++i) {
+            cv::Mat img(fmt.h, fmt.w, CV_8UC3);
+            rng.fill(img, cv::RNG::UNIFORM, 0, 256);
+            cv::GaussianBlur(img, img, cv::Size(9, 9), 3);
+            std::vector<uchar> enc;
+            cv::imencode(fmt.ext, img, enc);
+            pool.emplace_back(reinterpret_cast<const char*>(enc.data()), (qsizetype)enc.size());
+        }
+        auto blobAt = [&](int i) {
+            FaceBlob b;
+            b.id = i + 1;
+            b.userId = i / 5;
+            b.userName = QString("user%1").arg(i / 5);
+            b.data = pool[i % pool.size()];
+            return b;
+        };
+
+        Gallery legacy, streamed;
+        const LoadRun oldRun = measureLoad([&] {
+            QList<FaceBlob> buffered;
+            for (int i = 0; i < n; ++i) {
+                FaceBlob b = blobAt(i);
+                b.data = QByteArray(b.data.constData(), b.data.size()); // 결과 집합 버퍼링(행마다 사본)
+                buffered.push_back(b);
+            }
+            legacyLoad(buffered, legacy);
+            return (qint64)n;
+        });
+        const LoadRun newRun = measureLoad([&] {
+            int i = 0;
+            streamGallery([&](FaceBlob& b) {
+                if (i >= n)
+                    return false;
+                b = blobAt(i++);
+                return true;
+            }, streamed);
+            return (qint64)n;
+        });
+        printLoad(fmt.name, "legacy", oldRun);
+        printLoad(fmt.name, "stream", newRun);
+        qDebug().noquote() << QString("             speedup x%1, templates %2/%3, max mean |Δpixel| %4")
+                                  .arg(oldRun.ms / std::max(newRun.ms, 1e-3), 0, 'f', 2)
+                                  .arg(streamed.size()).arg(legacy.size())
+                                  .arg(maxTemplateDiff(legacy, streamed), 0, 'f', 2);
+    }
+
+    // 2. 실제 DB (LOADER_BENCH_DB=1): 기존 버퍼링 쿼리 + 직렬 디코딩 vs loadGalleryFromDb
+    if (envIntOr("LOADER_BENCH_DB", 0) != 1)
+        return 0;
+    DbManager db("Bench");
+    if (!db.open())
+        return 1;
+    Gallery legacy, streamed;
+    const LoadRun oldRun = measureLoad([&] {
+        QSqlQuery q(db.database());
+        QList<FaceBlob> buffered;
+        if (q.exec("SELECT id, user_id, user_name, face_data FROM face_images ORDER BY created_at ASC, id ASC")) {
+            while (q.next()) {
+                FaceBlob b;
+                b.id = q.value(0).toLongLong();
+                b.userId = q.value(1).toInt();
+                b.userName = q.value(2).toString().trimmed();
+                b.data = q.value(3).toByteArray();
+                buffered.push_back(b);
+            }
+        }
+        legacyLoad(buffered, legacy);
+        return (qint64)buffered.size();
+    });
+    GalleryLoadStats stats;
+    QString err;
+    const LoadRun newRun = measureLoad([&] {
+        if (!loadGalleryFromDb(db.database(), streamed, &err, &stats))
+            qWarning() << "[Bench loader] DB load failed:" << err;
+        return stats.rows;
+    });
+    printLoad("db", "legacy", oldRun);
+    printLoad("db", "stream", newRun);
+    qDebug().noquote() << QString("             blobs %1 MB, decode failed %2, templates %3/%4")
+                              .arg(stats.bytes / (1024.0 * 1024.0), 0, 'f', 1).arg(stats.failed)
+                              .arg(streamed.size()).arg(legacy.size());
+    db.close();
+    return 0;
+}
+
+
+// ---------- 여러 얼굴 ----------
+
+int benchMultiFace() {
+    const int counts[] = {1, 2, 3, 4, 6, 8};
+    const int gallerySize = 1000;
+    const int frames = 30;
+    cv::RNG rng(12345);
+
+    std::vector<cv::Mat> images;
+    std::vector<int> labels;
+    makeGallery(gallerySize, rng, images, labels);
+    std::unique_ptr<FaceRecognizer> recognizer = createFaceRecognizer();
+    recognizer->train(images, labels);
+
+    // 1280x720 프레임에 160x160 얼굴을 격자로 배치
+    cv::Mat frame(720, 1280, CV_8UC3);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(frame, frame, cv::Size(9, 9), 3);
+
+    qDebug().noquote() << QString("[Bench multiface] %1, gallery=%2, threads=%3, %4 frames each")
+                              .arg(recognizer->name()).arg(gallerySize).arg(cv::getNumThreads()).arg(frames);
+    qDebug().noquote() << "  faces | serial ms/frame | batch ms/frame | batch ms/face | batch p95 ms | speedup";
+
+    std::vector<cv::Mat> rois;
+    std::vector<FacePrediction> out;
+    for (int n : counts) {
+        std::vector<cv::Rect> faces;
+        for (int i = 0; i < n; ++i)
+            faces.emplace_back(40 + (i % 6) * 200, 60 + (i / 6) * 300, 160, 160);
+
+        // 기존 방식: 얼굴마다 차례로 전처리 + predict
+        const double serial = msOnce([&] {
+            for (int f = 0; f < frames; ++f) {
+                for (const cv::Rect& r : faces) {
+                    std::vector<cv::Mat> one;
+                    makeFaceBatch(frame, {r}, one);
+                    int label = -1;
+                    double score = 0.0;
+                    recognizer->predict(one[0], label, score);
+                }
+            }
+        }) / frames;
+
+        // 배치: 한 번에 전처리 → predictBatch (프레임별 지연 분포 기록)
+        std::vector<double> perFrame;
+        for (int f = 0; f < frames; ++f) {
+            perFrame.push_back(msOnce([&] {
+                makeFaceBatch(frame, faces, rois);
+                recognizer->predictBatch(rois, out);
+            }));
+        }
+        std::sort(perFrame.begin(), perFrame.end());
+        double batch = 0.0;
+        for (double ms : perFrame)
+            batch += ms;
+        batch /= frames;
+        const double p95 = perFrame[std::min(frames - 1, (int)(frames * 0.95))];
+
+        qDebug().noquote() << QString("  %1 | %2 | %3 | %4 | %5 | x%6")
+                                  .arg(n, 5).arg(serial, 15, 'f', 2).arg(batch, 14, 'f', 2)
+                                  .arg(batch / n, 13, 'f', 2).arg(p95, 12, 'f', 2)
+                                  .arg(serial / std::max(batch, 1e-3), 0, 'f', 2);
+    }
+    return 0;
+}
+
+} // namespace
+
+int runBench(const QString& name) {
+    if (name == "nn")
+        return benchNn();
+    if (name == "lbph")
+        return benchLbph();
+    if (name == "lbph-compact")
+        return benchLbphCompact();
+    if (name == "loader")
+        return benchLoader();
+    if (name == "multiface")
+        return benchMultiFace();
+
+    qWarning() << "[Bench] unknown benchmark:" << name << "(available: nn, lbph, lbph-compact, loader, multiface)";
+    return 1;
+}
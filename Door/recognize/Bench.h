@@ -0,0 +1,14 @@
+#pragma once
+#include <QString>
+
+// ---------- 벤치마크 (GUI 없이 실행) ----------
+// 사용: recognize --bench <name>
+//  nn           : NN 매처 — 갤러리 크기별 기존 루프 / 스칼라 / SIMD / SIMD+병렬 예측 시간
+//  lbph         : 내장 LBPH — 학습(1스레드/병렬), 예측(스칼라/SIMD/SIMD+병렬), contrib 있으면 시간·결과 비교
+//  lbph-compact : 저장 형식별(f32/u16/u8) 샘플당 메모리, 예측 시간, 변형 질의 정확도와 f32 대비 차이,
+//                 f32 기본 임계값과 수락 비율이 같은 compact 임계값(RECOGNIZER_THRESHOLD 보정용)
+//  loader       : 갤러리 적재 — 기존(버퍼링 + 직렬 디코딩) / 스트리밍 병렬 적재의 rows/s, 최대 RSS 증가량
+//                 합성 PNG/JPEG(LOADER_BENCH_ROWS, 기본 3000), LOADER_BENCH_DB=1이면 실제 DB도 측정
+//  multiface    : 프레임당 얼굴 수별 인식 지연 — 얼굴마다 차례로 / 배치 병렬(predictBatch), 평균·p95
+// 반환: 프로세스 종료 코드
+int runBench(const QString& name);
@@ -0,0 +1,87 @@
+#pragma once
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QDeadlineTimer>
+#include <deque>
+#include <utility>
+
+// 큐가 가득 찼을 때 처리 정책
+enum class DropPolicy {
+    DropOldest, // 가장 오래된 항목을 버리고 새 항목 저장 (최신 프레임 우선)
+    DropNewest  // 새 항목을 버림 (이미 쌓인 항목 유지)
+};
+
+// 스레드 간 전달용 고정 크기 큐 (생산자/소비자)
+// - 가득 차면 DropPolicy에 따라 한 개를 버리고 droppedCount() 증가
+// - close() 이후 push는 무시, pop은 남은 항목을 비운 뒤 false
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(int capacity = 2, DropPolicy policy = DropPolicy::DropOldest)
+        : cap(capacity > 0 ? capacity : 1), policy(policy) {}
+
+    // 반환: 새 항목이 큐에 들어갔으면 true
+    bool push(T item) {
+        QMutexLocker lock(&mtx);
+        if (closed)
+            return false;
+        if ((int)items.size() >= cap) {
+            ++dropped;
+            if (policy == DropPolicy::DropNewest)
+                return false;
+            items.pop_front();
+        }
+        items.push_back(std::move(item));
+        notEmpty.wakeOne();
+        return true;
+    }
+
+    // 항목이 들어올 때까지 최대 timeoutMs 대기 (0이면 대기하지 않음)
+    bool pop(T& out, int timeoutMs = 0) {
+        QMutexLocker lock(&mtx);
+        QDeadlineTimer deadline(timeoutMs);
+        while (items.empty() && !closed) {
+            if (timeoutMs <= 0 || !notEmpty.wait(&mtx, deadline))
+                break;
+        }
+        if (items.empty())
+            return false;
+        out = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+
+    // 대기 중인 소비자를 깨우고 이후 push 거부
+    void close() {
+        QMutexLocker lock(&mtx);
+        closed = true;
+        notEmpty.wakeAll();
+    }
+
+    // 재시작용 (남은 항목 비우고 다시 열기)
+    void reset() {
+        QMutexLocker lock(&mtx);
+        items.clear();
+        closed = false;
+    }
+
+    int size() const {
+        QMutexLocker lock(&mtx);
+        return (int)items.size();
+    }
+
+    quint64 droppedCount() const {
+        QMutexLocker lock(&mtx);
+        return dropped;
+    }
+
+private:
+    mutable QMutex mtx;
+    QWaitCondition notEmpty;
+    std::deque<T> items;
+    const int cap;
+    const DropPolicy policy;
+    quint64 dropped = 0;
+    bool closed = false;
+};
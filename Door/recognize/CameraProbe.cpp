@@ -0,0 +1,172 @@
+#include "CameraProbe.h"
+#include "Env.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+
+QString CameraCandidate::label() const {
+    return remote() ? url : QString("local:%1").arg(index);
+}
+
+// ---------- 탐색 스레드 ----------
+void CameraProbeThreads::start(std::function<void()> fn) {
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    std::lock_guard<std::mutex> lock(m);
+    reapLocked();
+    threads.push_back(Entry{std::thread([fn = std::move(fn), done]() {
+                                fn();
+                                done->store(true);
+                            }),
+                            done});
+}
+
+void CameraProbeThreads::joinAll() {
+    std::vector<Entry> all;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        all.swap(threads);
+    }
+    for (Entry& e : all)
+        e.thread.join();
+}
+
+int CameraProbeThreads::live() {
+    std::lock_guard<std::mutex> lock(m);
+    reapLocked();
+    return (int)threads.size();
+}
+
+void CameraProbeThreads::reapLocked() {
+    for (auto it = threads.begin(); it != threads.end();) {
+        if (it->done->load()) {
+            it->thread.join(); // 이미 끝남 → 바로 반환
+            it = threads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ---------- 후보 열기 ----------
+bool openCameraCandidate(const CameraCandidate& c, const StreamOptions& opt, cv::VideoCapture& cap, QString& status,
+                         const std::function<bool()>& stopped) {
+    // 로컬 장치 열기는 네트워크를 타지 않아 바로 끝남 (타임아웃 불필요)
+    if (!c.remote()) {
+        if (!cap.open(c.index))
+            return false;
+        status = QString("로컬 카메라 연결됨 (index=%1)").arg(c.index);
+        return true;
+    }
+
+    const auto halt = [&]() { return stopped && stopped(); };
+    // 기본 열기도 타임아웃을 지킴: FFmpeg은 open 파라미터, GStreamer는 rtspsrc 타임아웃이 들어간 기본 파이프라인
+    StreamOptions plain = opt;
+    plain.width = 0;
+    plain.gray = false;
+
+    const QString tuned = openTunedStream(cap, c.url, opt);
+    if (!tuned.isEmpty()) {
+        status = QString("원격 카메라(%1) 연결됨: %2").arg(tuned).arg(c.url);
+    } else if (!halt() && cap.open(c.url.toStdString(), cv::CAP_FFMPEG, ffmpegOpenParams(opt, false))) {
+        status = QString("원격 카메라(FFmpeg) 연결됨: %1").arg(c.url);
+    } else if (!halt() && cap.open(gstreamerPipeline(c.url, plain).toStdString(), cv::CAP_GSTREAMER)) {
+        status = QString("원격 카메라(GStreamer) 연결됨: %1").arg(c.url);
+    } else {
+        return false;
+    }
+    cap.set(cv::CAP_PROP_BUFFERSIZE, 1);
+    return true;
+}
+
+namespace {
+
+// 탐색 스레드들과 호출 측이 공유 (호출 측이 먼저 빠져도 마지막 스레드가 끝날 때까지 유지)
+struct ProbeState {
+    std::mutex m;
+    std::condition_variable cv;
+    int remotePending = 0;
+    int localPending = 0;
+    bool closed = false;        // 호출 측이 결과를 정함/포기 → 이후 열린 것은 바로 닫고 다음 방식도 시도 안 함
+    CameraProbeResult remote;   // 원격 첫 성공
+    CameraProbeResult local;    // 로컬 첫 성공
+};
+
+} // namespace
+
+bool probeCameras(const std::vector<CameraCandidate>& candidates, const StreamOptions& opt,
+                  const std::function<bool()>& cancelled, CameraProbeThreads& threads, CameraProbeResult& out) {
+    QElapsedTimer clock;
+    clock.start();
+    out = CameraProbeResult();
+    out.tried = (int)candidates.size();
+    if (candidates.empty())
+        return false;
+
+    const qint64 deadlineMs = std::max(1000, envIntOr("CAMERA_PROBE_MS", 10000));
+    const qint64 graceMs = std::max(0, envIntOr("CAMERA_REMOTE_GRACE_MS", 2000));
+
+    // 1. 원격/로컬 모두 동시에 시작
+    auto state = std::make_shared<ProbeState>();
+    for (const CameraCandidate& c : candidates)
+        (c.remote() ? state->remotePending : state->localPending)++;
+    for (const CameraCandidate& c : candidates) {
+        threads.start([state, c, opt]() {
+            auto cap = std::make_unique<cv::VideoCapture>();
+            QString status;
+            const bool ok = openCameraCandidate(c, opt, *cap, status, [state]() {
+                std::lock_guard<std::mutex> lock(state->m);
+                return state->closed;
+            });
+
+            std::unique_ptr<cv::VideoCapture> loser;
+            {
+                std::lock_guard<std::mutex> lock(state->m);
+                CameraProbeResult& slot = c.remote() ? state->remote : state->local;
+                if (ok && !state->closed && !slot.cap) {
+                    slot.cap = std::move(cap);
+                    slot.status = status;
+                } else if (ok) {
+                    loser = std::move(cap); // 이미 결과가 정해졌거나 같은 그룹의 다른 후보가 먼저 열림
+                }
+                (c.remote() ? state->remotePending : state->localPending)--;
+                state->cv.notify_all();
+            }
+            if (loser)
+                loser->release();
+        });
+    }
+
+    // 2. 원격 성공 → 바로 / 로컬 성공 → 원격이 모두 끝났거나 유예가 지나면 / 전부 실패·제한 시간·종료 요청이면 포기
+    //    (종료 요청/시간은 100ms마다 확인)
+    std::unique_ptr<cv::VideoCapture> unused;
+    bool ok = false;
+    {
+        std::unique_lock<std::mutex> lock(state->m);
+        for (;;) {
+            const qint64 elapsed = clock.elapsed();
+            if (state->remote.cap) {
+                out.cap = std::move(state->remote.cap);
+                out.status = state->remote.status;
+                unused = std::move(state->local.cap);
+                ok = true;
+                break;
+            }
+            if (state->local.cap && (state->remotePending == 0 || elapsed >= graceMs)) {
+                out.cap = std::move(state->local.cap);
+                out.status = state->local.status;
+                ok = true;
+                break;
+            }
+            if (state->remotePending + state->localPending == 0 || elapsed >= deadlineMs
+                || (cancelled && cancelled()))
+                break;
+            state->cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        state->closed = true;
+    }
+    if (unused)
+        unused->release();
+    out.ms = clock.elapsed();
+    return ok;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <QString>
+#include <QtGlobal>
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "StreamPipeline.h"
+
+// ---------- 카메라 후보 병렬 열기 ----------
+// 후보를 하나씩 열면 응답 없는 주소마다 네트워크 타임아웃(수~수십 초)이 쌓임
+// → 후보마다 별도 스레드에서 각자의 VideoCapture로 열고, 먼저 성공한 것을 사용(나머지는 열리면 바로 닫음)
+// 원격/로컬을 함께 열고, 로컬이 먼저 열려도 원격은 CAMERA_REMOTE_GRACE_MS(기본 2000, 탐색 시작부터)까지 기다려 줌
+// → 원격 우선순위는 유지하되 응답 없는 원격 주소가 로컬 폴백을 붙잡지 않음
+// 탐색 한 번의 제한 시간 CAMERA_PROBE_MS(기본 10000), 열기 시도마다 STREAM_OPEN_TIMEOUT_MS (StreamPipeline.h)
+struct CameraCandidate {
+    QString url;    // 원격 주소 (비어 있으면 로컬)
+    int index = -1; // 로컬 카메라 번호
+
+    bool remote() const { return !url.isEmpty(); }
+    QString label() const;
+};
+
+struct CameraProbeResult {
+    std::unique_ptr<cv::VideoCapture> cap;
+    QString status;   // 상태 표시용 ("원격 카메라(FFmpeg) 연결됨: ...")
+    qint64 ms = 0;    // 열기까지 걸린 시간
+    int tried = 0;    // 시도한 후보 수
+};
+
+// 탐색 스레드 보관 (detach 하지 않음)
+// 첫 성공으로 바로 진행하고 남은 열기는 뒤에서 끝나게 두되, 소유자가 종료 시 joinAll()로 모두 기다림
+// 열기마다 타임아웃이 있고 결과가 정해지면 다음 시도를 하지 않으므로 대기는 유한
+class CameraProbeThreads {
+public:
+    ~CameraProbeThreads() { joinAll(); }
+
+    void start(std::function<void()> fn); // 끝난 스레드를 먼저 정리(join)한 뒤 새 스레드 시작
+    void joinAll();
+    int live();                           // 아직 실행 중인 스레드 수
+
+private:
+    struct Entry {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+    std::mutex m;
+    std::vector<Entry> threads;
+
+    void reapLocked(); // 끝난 스레드 join (m 잠금 상태)
+};
+
+// 후보 하나 열기 (원격: 저지연 파이프라인 → FFmpeg → GStreamer, 로컬: index)
+// stopped()가 true가 되면 다음 방식을 시도하지 않음 (이미 다른 후보가 이겼거나 탐색이 끝남)
+bool openCameraCandidate(const CameraCandidate& c, const StreamOptions& opt, cv::VideoCapture& cap, QString& status,
+                         const std::function<bool()>& stopped = {});
+
+// 후보 병렬 열기. 원격 성공 / 로컬 성공 + 유예 경과 / 전부 실패 / 제한 시간 중 먼저 오는 것까지 대기
+// cancelled()가 true가 되면 false 반환 — 진행 중인 열기는 threads에 남아 끝난 뒤 스스로 닫힘
+bool probeCameras(const std::vector<CameraCandidate>& candidates, const StreamOptions& opt,
+                  const std::function<bool()>& cancelled, CameraProbeThreads& threads, CameraProbeResult& out);
@@ -0,0 +1,66 @@
+#include "CameraStats.h"
+#include <algorithm>
+
+void CameraStats::add(const FrameResult& res, qint64 nowMs) {
+    if (windowStart == 0) {
+        windowStart = nowMs;
+        skippedAtStart = res.skipped;
+    }
+    frames++;
+    faces += res.faces.size();
+    procSum += res.procMs;
+    predictSum += res.predictMs;
+    predictions += res.predictions;
+    const qint64 latency = nowMs - res.tsMs; // 캡처 → GUI 도착
+    latencySum += latency;
+    latencyMax = std::max(latencyMax, latency);
+    skippedLast = res.skipped;
+}
+
+void CameraStats::addRender(double ms) {
+    renders++;
+    renderSum += ms;
+}
+
+void CameraStats::addDisplay(double ms) {
+    displays++;
+    displaySum += ms;
+}
+
+QString CameraStats::takeSummary(const QString& name, quint64 dropped, qint64 nowMs) {
+    if (windowStart == 0 || nowMs - windowStart < windowMs)
+        return QString();
+
+    const double sec = (nowMs - windowStart) / 1000.0;
+    const double n = frames ? (double)frames : 1.0;
+    fps = frames / sec;
+    avgProc = procSum / n;
+    avgLatency = latencySum / n;
+    QString s = QString("[Camera %1] %2 fps | proc %3 ms (predict %4 ms) | latency avg %5 / max %6 ms"
+                        " | faces/frame %7 | skipped %8 | slot dropped %9")
+                    .arg(name)
+                    .arg(fps, 0, 'f', 1)
+                    .arg(avgProc, 0, 'f', 1).arg(predictSum / n, 0, 'f', 1)
+                    .arg(avgLatency, 0, 'f', 0).arg(latencyMax)
+                    .arg(faces / n, 0, 'f', 2)
+                    .arg(skippedLast - skippedAtStart)
+                    .arg(dropped);
+    s += QString(" | predictions %1/s").arg(predictions / sec, 0, 'f', 1);
+    s += QString(" | render %1 ms (%2 fps) | display %3 ms")
+             .arg(renders ? renderSum / renders : 0.0, 0, 'f', 1)
+             .arg(renders / sec, 0, 'f', 1)
+             .arg(displays ? displaySum / displays : 0.0, 0, 'f', 1);
+
+    windowStart = nowMs;
+    frames = faces = predictions = 0;
+    procSum = predictSum = latencySum = 0.0;
+    renders = displays = 0;
+    renderSum = displaySum = 0.0;
+    latencyMax = 0;
+    skippedAtStart = skippedLast;
+    return s;
+}
+
+QString CameraStats::overlay() const {
+    return QString("%1 fps, %2 ms").arg(fps, 0, 'f', 1).arg(avgLatency, 0, 'f', 0);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <QString>
+#include <QtGlobal>
+#include "FrameTypes.h"
+
+// ---------- 카메라별 처리 통계 ----------
+// GUI 스레드가 결과마다 add() — 최근 구간(기본 5초)의 FPS, 처리 지연, 캡처→표시 지연, 건너뛴 프레임
+// 화면 갱신(DISPLAY_FPS)마다 addRender()/addDisplay() — 그리기 비용을 별도 단계로 집계
+// 카메라마다 하나씩 두어 카메라를 늘렸을 때 각 파이프라인의 처리량을 따로 확인
+class CameraStats {
+public:
+    explicit CameraStats(qint64 windowMs = 5000) : windowMs(windowMs) {}
+
+    void add(const FrameResult& res, qint64 nowMs);
+    void addRender(double ms);  // 프레임 → 화면 이미지(변환 + 오버레이)
+    void addDisplay(double ms); // 화면 출력(축소/합성 + 픽스맵), 화면 갱신마다
+
+    // 구간이 끝났으면 요약을 만들고 새 구간 시작 (아니면 빈 문자열)
+    QString takeSummary(const QString& name, quint64 dropped, qint64 nowMs);
+
+    // 화면 표시용 한 줄 (직전 구간 기준)
+    QString overlay() const;
+
+private:
+    qint64 windowMs = 5000;
+    qint64 windowStart = 0;
+    quint64 frames = 0;
+    quint64 faces = 0;
+    double procSum = 0.0;
+    double predictSum = 0.0;
+    quint64 predictions = 0; // 실제 예측한 얼굴 수 (신원 캐시 사용분 제외)
+    double latencySum = 0.0;
+    qint64 latencyMax = 0;
+    quint64 skippedAtStart = 0;
+    quint64 skippedLast = 0;
+    quint64 renders = 0;
+    double renderSum = 0.0;
+    quint64 displays = 0;
+    double displaySum = 0.0;
+
+    // 직전 구간 결과
+    double fps = 0.0;
+    double avgProc = 0.0;
+    double avgLatency = 0.0;
+};
@@ -0,0 +1,171 @@
+#include "CaptureWorker.h"
+#include "Env.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+
+CaptureWorker::CaptureWorker(LatestFrameSlot* out, QObject* parent)
+    : QThread(parent), out(out) {}
+
+CaptureWorker::CaptureWorker(LatestFrameSlot* out, const QString& url, const QString& name, QObject* parent)
+    : QThread(parent), out(out), fixedUrl(url), tag(QString("[%1] ").arg(name)) {}
+
+CaptureWorker::~CaptureWorker() {
+    stop();
+}
+
+void CaptureWorker::stop() {
+    requestInterruption();
+    wait();
+    // 탐색이 먼저 끝나 남은 열기(열기 타임아웃까지) → OpenCV/GStreamer 정리 전에 끝나도록 대기
+    const int live = probeThreads.live();
+    if (live > 0)
+        qDebug().noquote() << tag + "[Capture] waiting for" << live << "camera probe thread(s)";
+    probeThreads.joinAll();
+}
+
+void CaptureWorker::sleepMs(int ms) {
+    for (int left = ms; left > 0 && !isInterruptionRequested(); left -= 100)
+        msleep(std::min(left, 100));
+}
+
+// ---------- 카메라 ----------
+// --- URL(원격) 우선, 실패 시 로컬로 폴백 (후보는 병렬로 열기) ---
+bool CaptureWorker::openBestCamera() {
+    // 1) 후보: 원격(Qt 환경변수 설정) + 로컬 0~2 (지정 카메라 모드에서는 다른 카메라로 대체하지 않음)
+    std::vector<CameraCandidate> candidates;
+    if (!fixedUrl.isEmpty()) {
+        candidates.push_back(CameraCandidate{fixedUrl});
+    } else {
+        for (const auto& s : envOr("STREAM_URLS").split(';', Qt::SkipEmptyParts))
+            candidates.push_back(CameraCandidate{s.trimmed()});
+        for (int idx : {0,1,2})
+            candidates.push_back(CameraCandidate{QString(), idx});
+    }
+
+    // 이미 열려 있으면 닫기
+    cap.reset();
+    delayMeter.reset();
+    outage.attempts++;
+
+    // 2) 병렬 열기: 원격 우선, 원격이 늦으면 로컬 (종료 요청이 오면 기다리지 않음)
+    CameraProbeResult probe;
+    if (probeCameras(candidates, StreamOptions::fromEnv(), [this]() { return isInterruptionRequested(); },
+                     probeThreads, probe)) {
+        cap = std::move(probe.cap);
+        retryFailures = 0;
+        emit statusChanged(tag + probe.status + QString(" [%1 ms]").arg(probe.ms));
+        return true;
+    }
+    if (isInterruptionRequested())
+        return false;
+
+    if (!fixedUrl.isEmpty())
+        emit statusChanged(tag + QString("카메라 열기 실패: %1").arg(fixedUrl));
+    else
+        emit statusChanged("카메라 열기 실패(원격/로컬 모두)");
+    beginOutage("열기 실패");
+    return false;
+}
+
+int CaptureWorker::nextRetryDelayMs() {
+    const int baseMs = std::max(100, envIntOr("CAMERA_RETRY_MS", 500));
+    const int maxMs = std::max(baseMs, envIntOr("CAMERA_RETRY_MAX_MS", 30000));
+    const int step = std::min(retryFailures++, 16);
+    const qint64 delay = std::min<qint64>(maxMs, qint64(baseMs) << step);
+    // ±20% 지터: 카메라 여러 대/같은 장비가 동시에 재시도해 몰리지 않도록
+    const int jitter = int(delay / 5);
+    return int(delay) + (jitter > 0 ? QRandomGenerator::global()->bounded(-jitter, jitter + 1) : 0);
+}
+
+// ---------- 끊김 집계 ----------
+void CaptureWorker::beginOutage(const QString& reason) {
+    if (outage.startMs != 0)
+        return;
+    outage.startMs = QDateTime::currentMSecsSinceEpoch();
+    qDebug().noquote() << tag + "[Capture] stream lost:" << reason;
+    emit streamLost();
+}
+
+void CaptureWorker::endOutage() {
+    const int attempts = outage.attempts;
+    outage.attempts = 0;
+    if (outage.startMs == 0)
+        return;
+
+    const qint64 ms = QDateTime::currentMSecsSinceEpoch() - outage.startMs;
+    outage.startMs = 0;
+    outage.count++;
+    outage.totalMs += ms;
+    outage.maxMs = std::max(outage.maxMs, ms);
+    qDebug().noquote() << tag + QString("[Capture] stream recovered after %1 ms (%2 attempts) | outages %3, total %4 ms, max %5 ms")
+                                    .arg(ms).arg(attempts).arg(outage.count).arg(outage.totalMs).arg(outage.maxMs);
+    emit streamRecovered(ms, attempts);
+}
+
+// ---------- 캡처 루프 ----------
+void CaptureWorker::run() {
+    quint64 seq = 0;
+    int emptyCount = 0;
+    QElapsedTimer statClock; // 버려진 프레임 수 주기 보고(5초)
+    statClock.start();
+
+    openBestCamera();
+
+    while (!isInterruptionRequested()) {
+        // 카메라가 없으면 백오프 후 재시도
+        if (!cap) {
+            sleepMs(nextRetryDelayMs());
+            if (!isInterruptionRequested())
+                openBestCamera();
+            continue;
+        }
+
+        // grab()으로 디코더 큐를 즉시 비우고, 캡처 시각은 grab 직후 기록
+        cv::Mat frame; // 매 프레임 새 버퍼(다음 단계와 공유되므로 재사용 금지)
+        QElapsedTimer decodeClock;
+        decodeClock.start();
+        const bool grabbed = cap->grab();
+        const qint64 tsMs = QDateTime::currentMSecsSinceEpoch();
+        if (grabbed) {
+            cap->retrieve(frame);
+            // 스트림 PTS 대비 도착 시각으로 네트워크/디코더 지연 추정
+            delayMeter.add(tsMs, cap->get(cv::CAP_PROP_POS_MSEC), decodeClock.nsecsElapsed() / 1e6);
+        }
+
+        // 프레임 손실 복구
+        if (frame.empty()) {
+            if (++emptyCount >= 15) { // 연속 15회 빈 프레임이면 재연결
+                emptyCount = 0;
+                emit statusChanged(tag + "카메라 프레임 끊김 → 재연결 시도");
+                beginOutage("15 empty frames");
+                cap.reset();
+                openBestCamera(); // 원격 우선, 실패 시 로컬 재시도 (실패하면 위에서 백오프)
+            } else {
+                msleep(33);
+            }
+            continue;
+        }
+        emptyCount = 0;
+        endOutage();
+
+        FramePacket pkt;
+        pkt.frame = frame;
+        pkt.seq = ++seq;
+        pkt.tsMs = tsMs;
+        out->publish(std::move(pkt)); // 소비자가 못 가져간 이전 프레임은 버려짐(집계)
+
+        if (statClock.elapsed() >= 5000) {
+            qDebug().noquote() << tag + "[Capture] published:" << out->publishedCount()
+                     << "dropped:" << out->droppedCount()
+                     << QString("| %1x%2x%3 | %4").arg(frame.cols).arg(frame.rows).arg(frame.channels())
+                            .arg(delayMeter.takeSummary());
+            statClock.restart();
+        }
+    }
+
+    cap.reset();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <QThread>
+#include <QString>
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include "CameraProbe.h"
+#include "LatestFrameSlot.h"
+#include "StreamPipeline.h"
+
+// 캡처(그래버) 스레드
+// - 카메라(원격 우선, 로컬 폴백)를 열고 디코더 버퍼를 쉬지 않고 비움(grab 연속 호출)
+// - 원격은 저지연 파이프라인(디코더 쪽 축소 + gray, StreamPipeline.h)을 먼저 시도 → 프레임이 gray일 수 있음
+// - 읽은 프레임은 순번/캡처 시각과 함께 LatestFrameSlot에 게시 (소비자는 항상 최신 프레임)
+// - 프레임이 끊기면 같은 스레드 안에서 재연결 (GUI는 막히지 않음)
+//   후보는 병렬로 열고(CameraProbe.h) 먼저 열린 것을 사용, 실패가 이어지면 지수 백오프 + 지터로 간격을 늘림
+//   CAMERA_RETRY_MS(기본 500) ~ CAMERA_RETRY_MAX_MS(기본 30000)
+// - 끊김/복구 시각을 신호로 알림 (GUI는 마지막 정상 프레임을 유지), 끊김 시간/횟수는 로그로 집계
+// - 기본: STREAM_URLS를 후보 목록으로 보고 열리는 하나를 사용(실패 시 로컬)
+//   url 지정: 그 카메라만 사용(다중 카메라 모드, 로컬 폴백 없음)
+class CaptureWorker : public QThread {
+    Q_OBJECT
+public:
+    explicit CaptureWorker(LatestFrameSlot* out, QObject* parent = nullptr);
+    CaptureWorker(LatestFrameSlot* out, const QString& url, const QString& name, QObject* parent = nullptr);
+    ~CaptureWorker() override;
+
+    void stop(); // 스레드 종료 요청 + 대기 (아직 열기 중인 탐색 스레드까지)
+
+signals:
+    void statusChanged(const QString& s);
+    void streamLost();                                   // 프레임 끊김/열기 실패 시작
+    void streamRecovered(qint64 outageMs, int attempts); // 끊김 후 첫 프레임
+
+protected:
+    void run() override;
+
+private:
+    // 끊김 집계 (캡처 스레드 전용)
+    struct OutageStats {
+        qint64 startMs = 0;   // 0이면 정상
+        int attempts = 0;     // 이번 끊김 동안 열기 시도 횟수
+        quint64 count = 0;    // 복구된 끊김 횟수
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+    };
+
+    LatestFrameSlot* out = nullptr; // 최신 프레임 슬롯(소유하지 않음)
+    std::unique_ptr<cv::VideoCapture> cap; // 카메라 (캡처 스레드 전용, 열려 있을 때만)
+    QString fixedUrl;     // 비어 있으면 STREAM_URLS 후보 + 로컬 폴백
+    QString tag;          // 상태/로그 앞에 붙는 카메라 이름 (다중 카메라 모드)
+    StreamDelayMeter delayMeter; // 디코딩 시간 + 스트림 지연(5초마다 로그)
+    OutageStats outage;
+    int retryFailures = 0; // 연속 열기 실패 (백오프 단계)
+    CameraProbeThreads probeThreads; // 후보 열기 스레드 (종료 시 모두 join)
+
+    bool openBestCamera();
+    int nextRetryDelayMs(); // 지수 백오프 + 지터
+    void sleepMs(int ms);   // 종료 요청에 바로 반응하는 대기
+    void beginOutage(const QString& reason);
+    void endOutage();
+};
@@ -0,0 +1,96 @@
+#include "DetectScale.h"
+#include <QStringList>
+#include <algorithm>
+
+double resizeForDetect(const cv::Mat& src, int detectWidth, cv::Mat& out) {
+    if (detectWidth <= 0 || src.cols <= detectWidth) {
+        out = src;
+        return 1.0;
+    }
+
+    // 1) 피라미드: 1/2 축소가 목표 폭 이상인 동안 반복 (가우시안 + 2배 축소, 가장 저렴)
+    cv::Mat cur = src;
+    while (cur.cols / 2 >= detectWidth) {
+        cv::Mat half;
+        cv::pyrDown(cur, half);
+        cur = half;
+    }
+    // 2) 남은 비율은 INTER_AREA로 맞춤
+    if (cur.cols > detectWidth) {
+        const int h = std::max(1, cvRound((double)cur.rows * detectWidth / cur.cols));
+        cv::Mat fit;
+        cv::resize(cur, fit, cv::Size(detectWidth, h), 0, 0, cv::INTER_AREA);
+        cur = fit;
+    }
+    out = cur;
+    return (double)cur.cols / src.cols;
+}
+
+double makeDetectGray(const cv::Mat& bgr, int detectWidth, cv::Mat& outGray) {
+    cv::Mat gray;
+    if (bgr.channels() == 3)
+        cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
+    else
+        gray = bgr;
+    return resizeForDetect(gray, detectWidth, outGray);
+}
+
+std::vector<cv::Rect> mapRectsToFull(const std::vector<cv::Rect>& rects, double scale, const cv::Size& full) {
+    std::vector<cv::Rect> out;
+    out.reserve(rects.size());
+    const cv::Rect bounds(0, 0, full.width, full.height);
+    for (const auto& r : rects) {
+        cv::Rect m(cvRound(r.x / scale), cvRound(r.y / scale),
+                   cvRound(r.width / scale), cvRound(r.height / scale));
+        m &= bounds;
+        if (m.area() > 0)
+            out.push_back(m);
+    }
+    return out;
+}
+
+cv::Size scaledMinSize(const cv::Size& fullMin, double scale) {
+    return cv::Size(std::max(24, cvRound(fullMin.width * scale)),
+                    std::max(24, cvRound(fullMin.height * scale)));
+}
+
+// ---------- 보고 ----------
+double DetectScaleReport::iou(const cv::Rect& a, const cv::Rect& b) {
+    const double inter = (a & b).area();
+    const double uni = a.area() + b.area() - inter;
+    return uni > 0 ? inter / uni : 0.0;
+}
+
+void DetectScaleReport::add(int detectWidth, double scale, double ms,
+                            const std::vector<cv::Rect>& found, const std::vector<cv::Rect>& truth) {
+    Stat& s = stats[detectWidth];
+    s.scale = scale;
+    s.totalMs += ms;
+    s.runs++;
+    s.truth += (int)truth.size();
+    for (const auto& t : truth) {
+        for (const auto& f : found) {
+            if (iou(t, f) >= 0.5) {
+                s.matched++;
+                break;
+            }
+        }
+    }
+}
+
+QString DetectScaleReport::summary() const {
+    QStringList lines;
+    lines << QString("[DetectScale] %1 frames").arg(frames);
+    for (const auto& kv : stats) {
+        const Stat& s = kv.second;
+        const double avgMs = s.runs ? s.totalMs / s.runs : 0.0;
+        const double recall = s.truth ? 100.0 * s.matched / s.truth : 100.0;
+        lines << QString("  width %1 (scale %2): %3 ms/frame, recall %4% (%5/%6)")
+                     .arg(kv.first == 0 ? QString("full") : QString::number(kv.first))
+                     .arg(s.scale, 0, 'f', 2)
+                     .arg(avgMs, 0, 'f', 1)
+                     .arg(recall, 0, 'f', 1)
+                     .arg(s.matched).arg(s.truth);
+    }
+    return lines.join('\n');
+}
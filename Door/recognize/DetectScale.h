@@ -0,0 +1,47 @@
+#pragma once
+#include <QString>
+#include <map>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ---------- 다중 해상도 검출 ----------
+// 검출은 축소된 gray 영상에서, 인식용 ROI는 원본 해상도에서 자른다.
+
+// 원본(BGR/gray 그대로) → 검출 폭 이하로 축소 (pyrDown 반복 + 나머지 INTER_AREA)
+// 반환: 축소 비율(검출 영상 / 원본)
+double resizeForDetect(const cv::Mat& src, int detectWidth, cv::Mat& out);
+
+// BGR 원본 → 검출용 gray (폭이 detectWidth 이하가 될 때까지 pyrDown, 나머지는 INTER_AREA)
+// 반환: 축소 비율(검출 영상 / 원본), detectWidth <= 0 이거나 원본이 더 작으면 1.0
+double makeDetectGray(const cv::Mat& bgr, int detectWidth, cv::Mat& outGray);
+
+// 축소 영상 좌표 → 원본 좌표 (원본 경계로 잘라냄)
+std::vector<cv::Rect> mapRectsToFull(const std::vector<cv::Rect>& rects, double scale, const cv::Size& full);
+
+// 원본 기준 최소 얼굴 크기를 축소 영상 기준으로 변환 (Haar 최소 창 24px 보장)
+cv::Size scaledMinSize(const cv::Size& fullMin, double scale);
+
+// 검출 폭(축소 단계)별 속도/재현율 누적 보고
+// - 기준(truth): 같은 프레임의 원본 해상도 검출 결과
+// - 재현율: 기준 얼굴 중 IoU >= 0.5로 대응되는 검출 비율
+class DetectScaleReport {
+public:
+    void add(int detectWidth, double scale, double ms, const std::vector<cv::Rect>& found, const std::vector<cv::Rect>& truth);
+    int samples() const { return frames; }
+    QString summary() const;
+    void clear() { stats.clear(); frames = 0; }
+    void countFrame() { ++frames; }
+
+    static double iou(const cv::Rect& a, const cv::Rect& b);
+
+private:
+    struct Stat {
+        double scale = 1.0;  // 마지막 실제 축소 비율
+        double totalMs = 0.0;
+        int runs = 0;
+        int truth = 0;
+        int matched = 0;
+    };
+    std::map<int, Stat> stats; // 검출 폭(0=원본) → 누적값
+    int frames = 0;
+};
@@ -0,0 +1,109 @@
+#include "DoorDecision.h"
+#include "Env.h"
+#include <QHash>
+#include <algorithm>
+
+DoorDecision::DoorDecision() {
+    confirmMs = std::max(0, envIntOr("OPEN_CONFIRM_MS", 200));
+    voteRatio = std::clamp(envIntOr("OPEN_VOTE_PCT", 80), 1, 100) / 100.0;
+    gapMs = std::max(1, envIntOr("DOOR_GAP_MS", 500));
+    closeGraceMs = std::max(0, envIntOr("CLOSE_GRACE_MS", 3000));
+    retryMs = std::max(100, envIntOr("DOOR_RETRY_MS", 1000));
+}
+
+int DoorDecision::openFailed(qint64 nowMs) {
+    const int delay = retryMs << std::min(retryFailures++, 3);
+    opened = false;
+    retryAtMs = nowMs + delay;
+    return delay;
+}
+
+DoorDecision::Track& DoorDecision::trackFor(int id) {
+    for (Track& t : tracks) {
+        if (t.id == id)
+            return t;
+    }
+    tracks.push_back(Track{id});
+    return tracks.back();
+}
+
+// 구간 [now - confirmMs, now]을 샘플별 시간으로 나눠 라벨별 득표 → 최다 라벨과 비율
+bool DoorDecision::voteOpen(const Track& t, qint64 nowMs, int& outLabel, double& outShare) const {
+    const qint64 windowStart = nowMs - confirmMs;
+    if (t.samples.empty() || t.samples.front().ms > windowStart)
+        return false; // 아직 구간 전체를 보지 못함
+    if (confirmMs == 0) {
+        outLabel = t.samples.back().label;
+        outShare = 1.0;
+        return outLabel != -1;
+    }
+
+    QHash<int, qint64> votes;
+    for (size_t i = 1; i < t.samples.size(); ++i) {
+        const qint64 from = std::max(t.samples[i - 1].ms, windowStart);
+        if (t.samples[i].ms > from)
+            votes[t.samples[i].label] += t.samples[i].ms - from;
+    }
+    outLabel = -1;
+    qint64 best = 0;
+    for (auto it = votes.cbegin(); it != votes.cend(); ++it) {
+        if (it.key() != -1 && it.value() > best) {
+            best = it.value();
+            outLabel = it.key();
+        }
+    }
+    outShare = double(best) / confirmMs;
+    return outLabel != -1 && outShare >= voteRatio;
+}
+
+DoorCommand DoorDecision::update(qint64 nowMs, const std::vector<DoorObservation>& faces) {
+    // 1. 트랙별 샘플 추가 (간격이 벌어졌으면 이전 표는 버림)
+    for (const DoorObservation& f : faces) {
+        Track& t = trackFor(f.trackId);
+        if (!t.samples.empty() && nowMs - t.samples.back().ms > gapMs) {
+            t.samples.clear();
+            t.firstAcceptMs = 0;
+        }
+        const int label = f.accepted ? f.label : -1;
+        t.samples.push_back(Sample{nowMs, label});
+        if (label != -1) {
+            lastAcceptMs = nowMs;
+            if (t.firstAcceptMs == 0)
+                t.firstAcceptMs = nowMs;
+        }
+    }
+
+    // 2. 오래된 샘플/트랙 정리 (구간 시작 이전 샘플은 하나만 남겨 구간의 시작점으로 사용)
+    const qint64 windowStart = nowMs - confirmMs;
+    for (Track& t : tracks) {
+        while (t.samples.size() > 1 && t.samples[1].ms <= windowStart)
+            t.samples.pop_front();
+    }
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [&](const Track& t) {
+                     return t.samples.empty() || nowMs - t.samples.back().ms > gapMs;
+                 }),
+                 tracks.end());
+
+    // 3. 닫힘 → 한 트랙이라도 투표를 통과하면 OPEN (직전 OPEN이 실행되지 않았으면 재시도 시각까지 대기)
+    if (!opened) {
+        if (nowMs < retryAtMs)
+            return DoorCommand::None;
+        for (const Track& t : tracks) {
+            int label = -1;
+            double share = 0.0;
+            if (voteOpen(t, nowMs, label, share)) {
+                reason = QString("label %1, vote %2% over %3 ms, first accept → open %4 ms")
+                             .arg(label).arg(share * 100.0, 0, 'f', 0).arg(confirmMs)
+                             .arg(t.firstAcceptMs ? nowMs - t.firstAcceptMs : 0);
+                openFace = t.firstAcceptMs;
+                return DoorCommand::Open;
+            }
+        }
+        return DoorCommand::None;
+    }
+
+    // 4. 열림 → 수락된 얼굴이 CLOSE_GRACE_MS 동안 없으면 CLOSE
+    if (nowMs - lastAcceptMs > closeGraceMs)
+        return DoorCommand::Close;
+    return DoorCommand::None;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <QString>
+#include <QtGlobal>
+#include <deque>
+#include <vector>
+
+// ---------- 문 열기/닫기 판단 (GUI 스레드) ----------
+// 프레임 수가 아니라 시간으로 판단 → 카메라/부하에 따라 FPS가 달라져도 열림 지연이 같음
+// - 얼굴 트랙마다 최근 OPEN_CONFIRM_MS(기본 200) 구간을 시간 가중 투표
+//   (샘플 하나 = 직전 샘플 이후 시간만큼의 표, 구간 내내 보인 트랙만 대상)
+//   같은 등록 라벨로 수락된 시간 비율이 OPEN_VOTE_PCT(기본 80)% 이상이면 OPEN
+// - 같은 트랙의 샘플 간격이 DOOR_GAP_MS(기본 500)보다 벌어지면 그 트랙의 표를 버림
+// - 수락된 얼굴이 CLOSE_GRACE_MS(기본 3000) 동안 없으면 CLOSE
+// - 장치가 OPEN을 실행하지 않으면(busy/lockout/시간 초과/포트 닫힘) DOOR_RETRY_MS(기본 1000) 뒤에 다시 OPEN
+//   연속 실패마다 2배(최대 8배), 실행되면 초기화 → 사람이 서 있는 동안 프레임마다 다시 보내지 않음
+// 시각은 프레임 캡처 시각(FrameResult::tsMs)을 사용 (GUI 처리 지연과 무관)
+enum class DoorCommand { None, Open, Close };
+
+// 문 카메라 프레임의 얼굴 하나
+struct DoorObservation {
+    int trackId = -1;
+    int label = -1;
+    bool accepted = false; // 현재 모델 임계값 기준 등록된 얼굴
+};
+
+class DoorDecision {
+public:
+    DoorDecision();
+
+    // 프레임 1장 반영 → 보낼 명령 (얼굴이 없거나 모델이 없으면 빈 목록)
+    DoorCommand update(qint64 nowMs, const std::vector<DoorObservation>& faces);
+
+    // 명령을 보낸 뒤 호출 (응답 전까지 열림으로 간주 → 중복 전송 방지)
+    void setOpen(bool open) { opened = open; }
+    bool isOpen() const { return opened; }
+    // OPEN 결과: 실행됨 → 재시도 간격 초기화 / 실행 안 됨 → 닫힘으로 되돌리고 재시도 대기(반환: 대기 ms)
+    void openDone() { retryFailures = 0; }
+    int openFailed(qint64 nowMs);
+
+    // 마지막 OPEN 근거 (로그용: 라벨, 투표 비율, 첫 수락 → OPEN 시간)
+    QString lastReason() const { return reason; }
+    // 마지막 OPEN을 만든 트랙이 처음 수락된 캡처 시각 (열림까지 걸린 시간 측정용)
+    qint64 openFaceMs() const { return openFace; }
+
+private:
+    struct Sample {
+        qint64 ms = 0;
+        int label = -1; // 수락되지 않았으면 -1
+    };
+    struct Track {
+        int id = -1;
+        std::deque<Sample> samples;
+        qint64 firstAcceptMs = 0; // 연속 관찰 중 처음 수락된 시각 (열림 지연 측정)
+    };
+
+    std::vector<Track> tracks;
+    bool opened = false;
+    qint64 lastAcceptMs = 0;
+    QString reason;
+    qint64 openFace = 0;
+
+    int confirmMs = 200;
+    double voteRatio = 0.8;
+    int gapMs = 500;
+    int closeGraceMs = 3000;
+    int retryMs = 1000;
+    int retryFailures = 0;  // 연속 OPEN 실패 (재시도 간격 단계)
+    qint64 retryAtMs = 0;   // 이 시각 전에는 OPEN 안 함
+
+    Track& trackFor(int id);
+    bool voteOpen(const Track& t, qint64 nowMs, int& outLabel, double& outShare) const;
+};
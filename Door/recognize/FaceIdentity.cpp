@@ -0,0 +1,119 @@
+#include "FaceIdentity.h"
+#include "Env.h"
+#include <algorithm>
+
+namespace {
+
+double iou(const cv::Rect& a, const cv::Rect& b) {
+    const double inter = (a & b).area();
+    const double uni = a.area() + b.area() - inter;
+    return uni > 0.0 ? inter / uni : 0.0;
+}
+
+} // namespace
+
+FaceIdentityCache::FaceIdentityCache() {
+    matchIou = envIntOr("IDENTITY_MATCH_IOU", 30) / 100.0;
+    repredictIou = envIntOr("IDENTITY_REPREDICT_IOU", 50) / 100.0;
+    repredictMs = std::max(0, envIntOr("IDENTITY_REPREDICT_MS", 1000));
+    unknownMs = std::max(0, envIntOr("IDENTITY_UNKNOWN_MS", 300));
+    // DoorDecision의 표 유지 간격보다 짧으면 그 간격 안의 재등장도 새 트랙이 됨 → 기본값을 맞춤
+    ttlMs = std::max(0, envIntOr("IDENTITY_TRACK_TTL_MS", envIntOr("DOOR_GAP_MS", 500)));
+}
+
+void FaceIdentityCache::assign(const std::vector<cv::Rect>& rects, qint64 nowMs, std::vector<int>& outIds) {
+    outIds.assign(rects.size(), 0);
+
+    // 1. 모든 (트랙, 얼굴) 쌍의 IoU → 큰 것부터 1:1 매칭 (얼굴 수가 적어 전수 비교로 충분)
+    struct Pair { double iou; int track; int face; };
+    std::vector<Pair> pairs;
+    for (int t = 0; t < (int)tracks.size(); ++t) {
+        for (int f = 0; f < (int)rects.size(); ++f) {
+            const double v = iou(tracks[t].rect, rects[f]);
+            if (v >= matchIou)
+                pairs.push_back(Pair{v, t, f});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.iou > b.iou; });
+
+    std::vector<Track> next;
+    next.reserve(rects.size());
+    std::vector<bool> trackUsed(tracks.size(), false);
+    for (const Pair& p : pairs) {
+        if (trackUsed[p.track] || outIds[p.face] != 0)
+            continue;
+        trackUsed[p.track] = true;
+        Track t = tracks[p.track];
+        t.rect = rects[p.face];
+        t.seenMs = nowMs;
+        outIds[p.face] = t.id;
+        next.push_back(t);
+    }
+
+    // 2. 매칭 안 된 트랙은 TTL 동안 유지 (마지막 박스로 다음 프레임에도 IoU 매칭 대상)
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        if (!trackUsed[t] && nowMs - tracks[t].seenMs <= ttlMs)
+            next.push_back(tracks[t]);
+    }
+
+    // 3. 매칭 안 된 얼굴 = 새 트랙
+    for (int f = 0; f < (int)rects.size(); ++f) {
+        if (outIds[f] != 0)
+            continue;
+        Track t;
+        t.id = nextId++;
+        t.rect = rects[f];
+        t.seenMs = nowMs;
+        outIds[f] = t.id;
+        next.push_back(t);
+    }
+    tracks.swap(next);
+}
+
+const FaceIdentityCache::Track* FaceIdentityCache::find(int id) const {
+    for (const Track& t : tracks) {
+        if (t.id == id)
+            return &t;
+    }
+    return nullptr;
+}
+
+bool FaceIdentityCache::needsPredict(int id, const cv::Rect& rect, qint64 nowMs) const {
+    const Track* t = find(id);
+    if (!t || !t->cached)
+        return true;
+    // 미인식/실패는 짧은 주기로 다시 (각도가 좋아지면 바로 인식되도록)
+    const bool known = t->pred.ok && t->pred.label != -1;
+    if (nowMs - t->predMs >= (known ? repredictMs : unknownMs))
+        return true;
+    return iou(t->predRect, rect) < repredictIou;
+}
+
+void FaceIdentityCache::store(int id, const cv::Rect& rect, const FacePrediction& p, qint64 nowMs) {
+    predicted++;
+    for (Track& t : tracks) {
+        if (t.id != id)
+            continue;
+        t.cached = true;
+        t.pred = p;
+        t.predRect = rect;
+        t.predMs = nowMs;
+        return;
+    }
+}
+
+bool FaceIdentityCache::lookup(int id, FacePrediction& out) const {
+    const Track* t = find(id);
+    if (!t || !t->cached)
+        return false;
+    out = t->pred;
+    return true;
+}
+
+void FaceIdentityCache::setModelVersion(quint64 version) {
+    if (version == modelVersion)
+        return;
+    modelVersion = version;
+    for (Track& t : tracks)
+        t.cached = false;
+}
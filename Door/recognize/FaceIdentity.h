@@ -0,0 +1,57 @@
+#pragma once
+#include <QtGlobal>
+#include <opencv2/core.hpp>
+#include <vector>
+#include "FaceRecognizer.h"
+
+// ---------- 얼굴 트랙 + 신원 캐시 (검출/인식 스레드 전용) ----------
+// 같은 사람을 프레임마다 다시 예측하지 않도록 얼굴마다 트랙 id를 붙이고 마지막 예측을 보관
+// - 트랙 매칭: 직전 프레임 박스와 IoU가 가장 큰 쌍부터(IDENTITY_MATCH_IOU 이상), 못 찾으면 새 id
+// - 안 보이는 트랙은 IDENTITY_TRACK_TTL_MS(기본 DOOR_GAP_MS = 500) 동안 마지막 박스로 남겨 둠
+//   → 검출이 몇 프레임 빠져도 같은 id/캐시로 이어지고, DoorDecision의 DOOR_GAP_MS 허용이 실제로 적용됨
+// - 다시 예측: 캐시 없음 / 오래됨(IDENTITY_REPREDICT_MS, 미인식 얼굴은 IDENTITY_UNKNOWN_MS)
+//             / 예측 당시 박스와 IoU가 IDENTITY_REPREDICT_IOU 미만(많이 움직임·크기 변화) / 모델 교체
+// 캐시된 예측은 "그때의 점수"이므로 수락 여부(accepts)는 GUI가 현재 모델 기준으로 판단
+class FaceIdentityCache {
+public:
+    FaceIdentityCache();
+
+    // 이번 프레임 얼굴들에 트랙 id 부여 (outIds[i] = rects[i]의 트랙), TTL이 지난 안 보이는 트랙은 제거
+    void assign(const std::vector<cv::Rect>& rects, qint64 nowMs, std::vector<int>& outIds);
+
+    bool needsPredict(int id, const cv::Rect& rect, qint64 nowMs) const;
+    void store(int id, const cv::Rect& rect, const FacePrediction& p, qint64 nowMs);
+    bool lookup(int id, FacePrediction& out) const;
+
+    // 모델 버전이 바뀌면 캐시 전체 무효화 (트랙 id는 유지)
+    void setModelVersion(quint64 version);
+
+    quint64 predictedCount() const { return predicted; }
+    quint64 reusedCount() const { return reused; }
+    void countReused() { reused++; }
+
+private:
+    struct Track {
+        int id = 0;
+        cv::Rect rect;           // 마지막으로 보인 박스
+        qint64 seenMs = 0;       // 마지막으로 보인 시각
+        bool cached = false;
+        FacePrediction pred;     // 마지막 예측
+        cv::Rect predRect;       // 예측 당시 박스
+        qint64 predMs = 0;       // 예측 시각
+    };
+
+    std::vector<Track> tracks;
+    int nextId = 1;
+    quint64 modelVersion = 0;
+    quint64 predicted = 0;
+    quint64 reused = 0;
+
+    double matchIou = 0.3;
+    double repredictIou = 0.5;
+    int repredictMs = 1000;
+    int unknownMs = 300;
+    int ttlMs = 500;
+
+    const Track* find(int id) const;
+};
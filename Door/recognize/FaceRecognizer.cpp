@@ -0,0 +1,289 @@
+#include "FaceRecognizer.h"
+#include "ShadowRecognizer.h"
+#include "NnMatcher.h"
+#include "LbphModel.h"
+#include "Env.h"
+#include <QDebug>
+#include <cfloat>
+
+#if __has_include(<opencv2/face.hpp>)
+#include <opencv2/face.hpp>
+#define HAS_OPENCV_FACE 1
+#else
+#define HAS_OPENCV_FACE 0
+#endif
+
+namespace {
+
+// 내장 LBPH(Float32) 기본 임계값 (contrib LBPH와 같은 척도)
+constexpr double kFloatThreshold = 75.0;
+
+// 임계값을 반드시 지정해야 하는 백엔드 (기본값 없음)
+bool needsExplicitThreshold(const QString& kind) {
+    return kind.trimmed().toLower() == "lbph-compact";
+}
+
+// ---------- LBPH (내장 엔진: contrib과 같은 파라미터, SIMD + 병렬 학습) ----------
+// compact: uniform 59 bin + 8/16비트 양자화 템플릿 (샘플당 64 KB → 3.7/7.4 KB)
+class LbphRecognizer : public FaceRecognizer {
+public:
+    explicit LbphRecognizer(LbphModel::Storage storage = LbphModel::Storage::Float32)
+        : model(storage) {
+        // LBPH 한계점(신뢰도) : 낮을수록 더 유사. 환경에 맞춰 조정.
+        // compact(uniform 59 bin + 양자화)는 거리 척도가 달라 근거 있는 기본값이 없음 → 0(모두 거부)
+        // createFaceRecognizer가 RECOGNIZER_THRESHOLD를 요구 (값은 --bench lbph-compact의 "f32 동일 수락 임계값")
+        thresh = storage == LbphModel::Storage::Float32 ? kFloatThreshold : 0.0;
+    }
+
+    QString name() const override {
+        if (model.storage() == LbphModel::Storage::Float32)
+            return "LBPH";
+        return QString("LBPH-%1").arg(LbphModel::storageName(model.storage()));
+    }
+    QString scoreName() const override { return "신뢰도"; }
+    bool empty() const override { return model.empty(); }
+    int sampleCount() const override { return model.size(); }
+
+    bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        if (!model.train(images, labels)) {
+            qWarning() << "[LBPH] train failed: invalid image (gray 10x10 이상 필요)";
+            return false;
+        }
+        reportMemory();
+        return true;
+    }
+
+    bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        if (!model.update(images, labels)) {
+            qWarning() << "[LBPH] update failed: invalid image (gray 10x10 이상 필요)";
+            return false;
+        }
+        return true;
+    }
+
+    bool retain(const std::vector<char>& keep, const std::vector<int>& labels) override {
+        return model.retain(keep, labels);
+    }
+
+    bool predict(const cv::Mat& gray128, int& outLabel, double& outScore) const override {
+        // chi-square 거리 = contrib predict의 confidence와 같은 척도
+        return model.predict(gray128, outLabel, outScore);
+    }
+
+    std::unique_ptr<FaceRecognizer> clone() const override {
+        return std::make_unique<LbphRecognizer>(*this); // 히스토그램 행렬은 깊은 복사(LbphModel)
+    }
+
+private:
+    void reportMemory() const {
+        const double perSample = model.bytesPerSample();
+        qDebug().noquote() << QString("[%1] %2 samples, %3 KB/sample, total %4 MB")
+                                  .arg(name()).arg(model.size())
+                                  .arg(perSample / 1024.0, 0, 'f', 1)
+                                  .arg(perSample * model.size() / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+
+    LbphModel model;
+};
+
+#if HAS_OPENCV_FACE
+// ---------- LBPH (opencv_contrib) : 내장 엔진과 비교(섀도 모드/벤치)용 ----------
+class ContribLbphRecognizer : public FaceRecognizer {
+public:
+    ContribLbphRecognizer() {
+        thresh = 75.0; // LBPH 한계점(신뢰도) : 낮을수록 더 유사. 환경에 맞춰 조정.
+        model = cv::face::LBPHFaceRecognizer::create(1, 8, 8, 8, DBL_MAX);
+    }
+
+    QString name() const override { return "LBPH(contrib)"; }
+    QString scoreName() const override { return "신뢰도"; }
+    bool empty() const override { return count == 0; }
+    int sampleCount() const override { return count; }
+
+    bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        try {
+            model->train(images, labels);
+        } catch (const cv::Exception& e) {
+            qWarning() << "[LBPH] train failed:" << e.what();
+            return false;
+        }
+        count = (int)images.size();
+        return true;
+    }
+
+    bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        if (images.empty())
+            return true;
+        try {
+            if (count == 0) model->train(images, labels);
+            else            model->update(images, labels);
+        } catch (const cv::Exception& e) {
+            qWarning() << "[LBPH] update failed:" << e.what();
+            return false;
+        }
+        count += (int)images.size();
+        return true;
+    }
+
+    bool predict(const cv::Mat& gray128, int& outLabel, double& outScore) const override {
+        if (count == 0)
+            return false;
+        // 판정(threshold)은 호출 측에서 accepts()로 수행하므로 모델 임계값은 두지 않음
+        model->predict(gray128, outLabel, outScore);
+        return outLabel != -1;
+    }
+
+private:
+    cv::Ptr<cv::face::LBPHFaceRecognizer> model;
+    int count = 0;
+};
+#endif
+
+// ---------- 최근접 이웃(L2) : 품질은 낮지만 의존성 없이 동작 ----------
+class NnRecognizer : public FaceRecognizer {
+public:
+    NnRecognizer() {
+        thresh = 3000.0; // NN 한계점(거리) : L2 거리 임계값(환경에 맞춰 조정)
+    }
+
+    QString name() const override { return "NN"; }
+    QString scoreName() const override { return "거리"; }
+    bool empty() const override { return matcher.empty(); }
+    int sampleCount() const override { return matcher.size(); }
+
+    bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        matcher.clear();
+        return update(images, labels);
+    }
+
+    bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override {
+        matcher.reserve(matcher.size() + (int)images.size());
+        for (size_t i = 0; i < images.size() && i < labels.size(); ++i)
+            matcher.add(images[i], labels[i]);
+        return true;
+    }
+
+    bool retain(const std::vector<char>& keep, const std::vector<int>& labels) override {
+        return matcher.retain(keep, labels);
+    }
+
+    bool predict(const cv::Mat& gray128, int& outLabel, double& outScore) const override {
+        // 최근접 이웃 (L2 거리, 연속 갤러리 + SIMD). 낮을수록 유사.
+        return matcher.match(gray128, outLabel, outScore);
+    }
+
+    std::unique_ptr<FaceRecognizer> clone() const override {
+        return std::make_unique<NnRecognizer>(*this); // 갤러리 행렬은 깊은 복사(NnMatcher)
+    }
+
+private:
+    NnMatcher matcher; // gray 128x128 갤러리 (N x 16384 연속 행렬)
+};
+
+} // namespace
+
+// ---------- 배치 예측 ----------
+void FaceRecognizer::predictBatch(const std::vector<cv::Mat>& gray128s, std::vector<FacePrediction>& out) const {
+    out.assign(gray128s.size(), FacePrediction());
+    auto one = [&](int i) {
+        FacePrediction& p = out[i];
+        if (gray128s[i].empty())
+            return; // 프레임 밖으로 벗어난 얼굴
+        p.ok = predict(gray128s[i], p.label, p.score);
+    };
+    // 얼굴 1개는 predict() 내부 병렬(갤러리 분할)을 그대로 사용
+    // 여러 개면 얼굴 단위로 나눔(안쪽 parallel_for_는 OpenCV가 직렬로 실행)
+    if (gray128s.size() == 1) {
+        one(0);
+        return;
+    }
+    cv::parallel_for_(cv::Range(0, (int)gray128s.size()), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i)
+            one(i);
+    });
+}
+
+void makeFaceBatch(const cv::Mat& frameBgr, const std::vector<cv::Rect>& faces, std::vector<cv::Mat>& out) {
+    out.resize(faces.size());
+    const cv::Rect bounds(0, 0, frameBgr.cols, frameBgr.rows);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const cv::Rect r = faces[i] & bounds;
+        if (r.area() <= 0) {
+            out[i].release();
+            continue;
+        }
+        cv::Mat gray;
+        if (frameBgr.channels() == 3)
+            cv::cvtColor(frameBgr(r), gray, cv::COLOR_BGR2GRAY);
+        else
+            gray = frameBgr(r); // gray 스트림
+        cv::resize(gray, out[i], cv::Size(128, 128));
+    }
+}
+
+QStringList faceRecognizerKinds() {
+#if HAS_OPENCV_FACE
+    return {"lbph", "nn", "lbph-compact", "lbph-contrib"};
+#else
+    return {"lbph", "nn", "lbph-compact"};
+#endif
+}
+
+std::unique_ptr<FaceRecognizer> createRecognizerBackend(const QString& kind) {
+    const QString k = kind.trimmed().toLower();
+    if (k == "lbph")
+        return std::make_unique<LbphRecognizer>();
+    if (k == "lbph-compact") {
+        // LBPH_COMPACT_BITS=8|16 (기본 8)
+        const bool wide = envIntOr("LBPH_COMPACT_BITS", 8) == 16;
+        return std::make_unique<LbphRecognizer>(wide ? LbphModel::Storage::Uniform16 : LbphModel::Storage::Uniform8);
+    }
+#if HAS_OPENCV_FACE
+    if (k == "lbph-contrib")
+        return std::make_unique<ContribLbphRecognizer>();
+#endif
+    if (k == "nn")
+        return std::make_unique<NnRecognizer>();
+    return nullptr;
+}
+
+std::unique_ptr<FaceRecognizer> createFaceRecognizer(const QString& kind) {
+    const QString want = kind.isEmpty() ? envOr("FACE_RECOGNIZER", faceRecognizerKinds().first()) : kind;
+
+    bool ok = false;
+    const double t = envOr("RECOGNIZER_THRESHOLD").toDouble(&ok);
+    std::unique_ptr<FaceRecognizer> rec;
+    if (needsExplicitThreshold(want) && !ok)
+        qWarning() << "[FaceRecognizer]" << want << "needs RECOGNIZER_THRESHOLD"
+                   << "(calibrate with: recognize --bench lbph-compact), falling back to" << faceRecognizerKinds().first();
+    else
+        rec = createRecognizerBackend(want);
+    if (!rec) {
+        if (!needsExplicitThreshold(want))
+            qWarning() << "[FaceRecognizer]" << want << "not available, falling back to" << faceRecognizerKinds().first();
+        rec = createRecognizerBackend(faceRecognizerKinds().first());
+    }
+    if (ok)
+        rec->setThreshold(t);
+
+    // 섀도 모드: 후보 백엔드를 샘플 프레임에서만 비동기로 함께 실행, 지연/일치율 기록
+    const QString shadowKind = envOr("SHADOW_RECOGNIZER");
+    if (!shadowKind.isEmpty()) {
+        bool tok = false;
+        const double st = envOr("SHADOW_THRESHOLD").toDouble(&tok);
+        std::unique_ptr<FaceRecognizer> cand = createRecognizerBackend(shadowKind);
+        if (cand && needsExplicitThreshold(shadowKind) && !tok) {
+            // 판정 일치율이 의미 없어짐 → 후보 임계값 없이는 섀도 모드를 켜지 않음
+            qWarning() << "[FaceRecognizer] shadow backend" << shadowKind << "needs SHADOW_THRESHOLD";
+            return rec;
+        }
+        if (cand) {
+            if (tok)
+                cand->setThreshold(st);
+            return std::make_unique<ShadowRecognizer>(std::move(rec), std::move(cand),
+                                                      envIntOr("SHADOW_SAMPLE_EVERY", 10));
+        }
+        qWarning() << "[FaceRecognizer] shadow backend" << shadowKind << "not available";
+    }
+    return rec;
+}
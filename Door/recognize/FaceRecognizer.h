@@ -0,0 +1,69 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// 얼굴 하나의 예측 결과 (predictBatch)
+struct FacePrediction {
+    bool ok = false;    // 예측 수행/성공 여부
+    int label = -1;
+    double score = 0.0;
+};
+
+// ---------- 얼굴 인식기 공통 인터페이스 ----------
+// 입력: gray 128x128 (CV_8U), 점수는 낮을수록 유사 (LBPH 신뢰도 / NN 거리)
+// 백엔드: lbph(내장 LBPH), nn(L2 최근접 이웃), lbph-compact(uniform LBP + 양자화, LBPH_COMPACT_BITS=8|16),
+//        lbph-contrib(opencv_contrib 있을 때) — 모두 함께 빌드되고 실행 시 선택
+// 선택: FACE_RECOGNIZER=lbph|nn|lbph-compact|lbph-contrib, 임계값 RECOGNIZER_THRESHOLD(없으면 백엔드 기본값)
+//      lbph-compact는 기본값이 없어 RECOGNIZER_THRESHOLD 필수(없으면 lbph로 대체), 값은 --bench lbph-compact로 보정
+// 학습(train/update)이 끝난 뒤 predict()는 여러 스레드에서 동시에 호출될 수 있음(읽기 전용)
+class FaceRecognizer {
+public:
+    virtual ~FaceRecognizer() = default;
+
+    virtual QString name() const = 0;
+    virtual QString scoreName() const = 0;   // 화면 표시용 점수 이름("신뢰도"/"거리")
+    virtual bool empty() const = 0;
+    virtual int sampleCount() const = 0;
+
+    // 전체 학습(기존 내용 대체)
+    virtual bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) = 0;
+    // 증분 학습(기존 내용 유지 + 추가)
+    virtual bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) = 0;
+    // 대상 갱신: 학습 순서 기준 keep[i]가 0인 샘플만 빼고, 남은 샘플의 라벨을 labels(남은 순서)로 교체
+    // 특징(히스토그램/템플릿)은 다시 계산하지 않음. false면 지원 안 함 → 호출 측이 전체 재학습
+    virtual bool retain(const std::vector<char>& keep, const std::vector<int>& labels) {
+        (void)keep; (void)labels;
+        return false;
+    }
+    // 예측: 가장 유사한 라벨과 점수
+    virtual bool predict(const cv::Mat& gray128, int& outLabel, double& outScore) const = 0;
+    // 여러 얼굴을 한 번에 예측 (결과는 입력과 같은 순서)
+    // 기본: 얼굴이 2개 이상이면 cv::parallel_for_로 얼굴마다 predict() — 얼굴 수가 늘어도 지연이 코어 수만큼 나뉨
+    virtual void predictBatch(const std::vector<cv::Mat>& gray128s, std::vector<FacePrediction>& out) const;
+    // 증분 갱신용 복제 (게시된 모델은 그대로 두고 복제본에 update 후 교체)
+    // nullptr이면 복제 불가 → 템플릿으로 전체 재학습
+    virtual std::unique_ptr<FaceRecognizer> clone() const { return nullptr; }
+
+    double threshold() const { return thresh; }
+    void setThreshold(double t) { thresh = t; }
+    bool accepts(double score) const { return score <= thresh; }
+
+protected:
+    double thresh = 0.0;
+};
+
+// 프레임(BGR 또는 gray)의 얼굴 영역들 → 인식 입력 배치(gray 128x128, faces와 같은 순서)
+void makeFaceBatch(const cv::Mat& frameBgr, const std::vector<cv::Rect>& faces, std::vector<cv::Mat>& out);
+
+// 이름으로 인식기 생성 ("" 이면 FACE_RECOGNIZER, 없으면 lbph)
+// SHADOW_RECOGNIZER가 지정되면 섀도 모드로 감싸서 반환
+std::unique_ptr<FaceRecognizer> createFaceRecognizer(const QString& kind = QString());
+
+// 섀도 모드 없이 백엔드 하나만 생성 (사용 불가하면 nullptr)
+std::unique_ptr<FaceRecognizer> createRecognizerBackend(const QString& kind);
+
+// 이 빌드에서 사용할 수 있는 백엔드 목록
+QStringList faceRecognizerKinds();
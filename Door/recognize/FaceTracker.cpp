@@ -0,0 +1,105 @@
+#include "FaceTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int    kMinPoints = 6;     // 이보다 적게 남으면 추적 실패
+const double kMaxFbError = 1.0;  // 정방향→역방향 왕복 오차 허용(px)
+
+float medianOf(std::vector<float>& v) {
+    const size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    return v[mid];
+}
+}
+
+void FaceTracker::reset() {
+    prevGray.release();
+    pts.clear();
+    conf = 0.0;
+}
+
+// 검출된 얼굴 안쪽(가장자리 배경 제외)에서 특징점 선택
+void FaceTracker::init(const cv::Mat& gray, const cv::Rect& face) {
+    reset();
+    const cv::Rect inner = cv::Rect(face.x + face.width / 6, face.y + face.height / 6,
+                                    face.width * 2 / 3, face.height * 2 / 3)
+                           & cv::Rect(0, 0, gray.cols, gray.rows);
+    if (inner.area() <= 0)
+        return;
+
+    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8U);
+    mask(inner).setTo(255);
+    cv::goodFeaturesToTrack(gray, pts, 40, 0.01, 3, mask);
+    if ((int)pts.size() < kMinPoints) {
+        pts.clear();
+        return;
+    }
+    prevGray = gray;
+    box = cv::Rect2f(face);
+    conf = 1.0;
+}
+
+bool FaceTracker::update(const cv::Mat& gray, cv::Rect& outFace) {
+    if (!active() || gray.size() != prevGray.size()) {
+        reset();
+        return false;
+    }
+
+    // 1. 정방향 + 역방향 광류
+    std::vector<cv::Point2f> next, back;
+    std::vector<uchar> st1, st2;
+    std::vector<float> err;
+    const cv::Size win(15, 15);
+    cv::calcOpticalFlowPyrLK(prevGray, gray, pts, next, st1, err, win, 2);
+    cv::calcOpticalFlowPyrLK(gray, prevGray, next, back, st2, err, win, 2);
+
+    // 2. 왕복 오차가 작은 점만 유지
+    std::vector<cv::Point2f> from, to;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        if (!st1[i] || !st2[i])
+            continue;
+        const cv::Point2f d = pts[i] - back[i];
+        if (std::sqrt(d.dot(d)) > kMaxFbError)
+            continue;
+        from.push_back(pts[i]);
+        to.push_back(next[i]);
+    }
+    conf = pts.empty() ? 0.0 : (double)from.size() / pts.size();
+    if ((int)from.size() < kMinPoints) {
+        reset();
+        return false;
+    }
+
+    // 3. 이동량 = 변위 중앙값, 크기 변화 = 점 쌍 거리 비율 중앙값
+    std::vector<float> dx, dy, ratios;
+    for (size_t i = 0; i < from.size(); ++i) {
+        dx.push_back(to[i].x - from[i].x);
+        dy.push_back(to[i].y - from[i].y);
+    }
+    for (size_t i = 0; i + 1 < from.size(); i += 2) {
+        const cv::Point2f a = from[i] - from[i + 1];
+        const cv::Point2f b = to[i] - to[i + 1];
+        const float da = std::sqrt(a.dot(a));
+        if (da > 1.0f)
+            ratios.push_back(std::sqrt(b.dot(b)) / da);
+    }
+    const float mx = medianOf(dx);
+    const float my = medianOf(dy);
+    const float s = ratios.empty() ? 1.0f : std::clamp(medianOf(ratios), 0.8f, 1.25f);
+
+    const cv::Point2f c(box.x + box.width / 2 + mx, box.y + box.height / 2 + my);
+    box = cv::Rect2f(c.x - box.width * s / 2, c.y - box.height * s / 2, box.width * s, box.height * s);
+
+    // 4. 화면 밖으로 대부분 나가면 실패
+    const cv::Rect r = cv::Rect(box) & cv::Rect(0, 0, gray.cols, gray.rows);
+    if (r.area() < box.area() / 2) {
+        reset();
+        return false;
+    }
+
+    prevGray = gray; // 참조만 보관: 호출 측은 이 버퍼에 그리지 않아야 함 (RecognizeWorker::process 참고)
+    pts = to;
+    outFace = r;
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// 얼굴 1개 추적기 (피라미드 Lucas-Kanade 광류)
+// - 검출 직후 init()으로 얼굴 영역 안의 특징점을 잡고, 이후 프레임은 update()로 이동/크기 추정
+// - 정방향/역방향 광류 오차(FB error)로 걸러낸 점의 비율을 신뢰도로 사용
+// - 신뢰도가 낮거나 점이 부족하면 false → 호출 측에서 전체 검출 수행
+class FaceTracker {
+public:
+    void init(const cv::Mat& gray, const cv::Rect& face);
+    bool update(const cv::Mat& gray, cv::Rect& outFace);
+    void reset();
+
+    bool active() const { return !pts.empty(); }
+    double confidence() const { return conf; }
+
+private:
+    cv::Mat prevGray;
+    std::vector<cv::Point2f> pts;
+    cv::Rect2f box;
+    double conf = 0.0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <QMetaType>
+#include <QtGlobal>
+#include <opencv2/core.hpp>
+#include <vector>
+
+// 캡처 단계 → 검출/인식 단계로 넘기는 프레임
+struct FramePacket {
+    cv::Mat frame;       // 원본 프레임 (BGR, 저지연 원격 파이프라인이면 축소된 gray)
+    quint64 seq = 0;     // 캡처 순번(1부터 증가)
+    qint64  tsMs = 0;    // 캡처 시각(ms, QDateTime 기준)
+};
+
+// 얼굴 하나의 검출/인식 결과
+struct FaceResult {
+    cv::Rect rect;                  // 원본 프레임 좌표
+    bool predicted = false;         // 예측 수행/성공 여부
+    int label = -1;                 // 예측 라벨
+    double score = 0.0;             // LBPH 신뢰도 또는 NN 거리 (낮을수록 유사)
+    int trackId = -1;               // 얼굴 트랙 id (같은 사람이면 프레임이 바뀌어도 유지)
+    bool cached = false;            // 이번 프레임은 예측 없이 트랙의 신원 캐시 사용
+};
+
+// 검출/인식 단계 → GUI 단계로 넘기는 결과
+struct FrameResult {
+    cv::Mat frame;                  // 얼굴 박스가 그려진 프레임
+    std::vector<FaceResult> faces;  // 검출된 얼굴 전체 + 얼굴별 예측 (모든 얼굴을 인식)
+    bool tracked = false;           // 전체 검출 대신 추적으로 얻은 얼굴이면 true
+    quint64 seq = 0;                // 원본 프레임 순번
+    qint64  tsMs = 0;               // 원본 프레임 캡처 시각(ms)
+    double  detectMs = 0.0;         // 전체 검출 지연시간(ms, 추적 프레임은 0)
+    double  predictMs = 0.0;        // 얼굴 전체 전처리 + 배치 예측 시간(ms)
+    int     predictions = 0;        // 이번 프레임에서 실제로 예측한 얼굴 수 (나머지는 캐시)
+    qint64  procMs = 0;             // 검출+인식 처리 시간(ms)
+    quint64 skipped = 0;            // 검출 단계가 건너뛴 누적 프레임 수
+};
+
+Q_DECLARE_METATYPE(FrameResult)
@@ -0,0 +1,100 @@
+#pragma once
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <opencv2/core.hpp>
+#include <vector>
+
+// QPair<int, QString>형 key
+inline uint qHash(const QPair<int, QString>& key, uint seed = 0) {
+    return qHash(key.first, seed) ^ qHash(key.second, seed * 1315423911u);
+}
+
+// 갤러리가 반영한 face_images 상태 (디코딩 실패 행 포함) — 증분 갱신 시 새 행/삭제 판단 기준
+struct GallerySource {
+    qint64 rows = 0;   // COUNT(*)
+    qint64 idSum = 0;  // SUM(id) : 행 수가 같아도 삭제 + 추가가 섞이면 달라짐
+    qint64 maxId = 0;  // MAX(id) : 이보다 큰 id가 새 행
+
+    bool operator==(const GallerySource& o) const { return rows == o.rows && idSum == o.idSum && maxId == o.maxId; }
+    bool operator!=(const GallerySource& o) const { return !(*this == o); }
+};
+
+// ---------- 학습 갤러리 ----------
+// DB 행을 전처리한 템플릿(gray 128x128)과 라벨 매핑. 인식기 백엔드와 무관(캐시/재학습에 그대로 사용)
+struct Gallery {
+    std::vector<cv::Mat> images;                 // gray 128x128 (CV_8U)
+    std::vector<int> labels;                     // images와 같은 순서의 내부 정수 라벨
+    std::vector<qint64> rowIds;                  // face_images.id
+    std::vector<int> userIds;                    // face_images.user_id
+    std::vector<QString> userNames;              // face_images.user_name (trim)
+    QHash<int, QString> labelToName;             // 예측라벨(int) -> 표시이름(String)
+    QHash<QPair<int, QString>, int> pairToLabel; // user_id, user_name -> 내부 정수 라벨
+    QSet<int> conflictIds;                       // 충돌 : 특정 user_id에 복수 이름이 있는 ID
+    int nextLabelId = 1;
+    GallerySource source;
+
+    int size() const { return (int)images.size(); }
+    bool empty() const { return images.empty(); }
+    int classCount() const { return QSet<int>(labels.begin(), labels.end()).size(); }
+
+    void clear() {
+        *this = Gallery();
+    }
+
+    // uid, uname 를 정수 라벨로 매핑
+    int ensureLabelForPair(int uid, const QString& uname) {
+        const QPair<int, QString> key(uid, uname);
+        if (!pairToLabel.contains(key)) {
+            const int label = nextLabelId++;
+            pairToLabel.insert(key, label);
+            labelToName.insert(label, uname);
+        }
+        return pairToLabel.value(key);
+    }
+
+    // DB 행 하나를 라벨링해 추가
+    int add(qint64 rowId, int uid, const QString& uname, const cv::Mat& gray128) {
+        int labelInt = -1;
+        if (conflictIds.contains(uid)) {
+            // 충돌: user_id는 (uid, uname) 단위로 분리
+            labelInt = ensureLabelForPair(uid, uname);
+        } else {
+            // 충돌 없음: user_id 하나당 단일 이름으로 간주
+            // 같은 user_id의 모든 샘플은 같은 labelInt 사용
+            labelInt = ensureLabelForPair(uid, uname.isEmpty() ? QString::number(uid) : uname);
+        }
+        images.push_back(gray128);
+        labels.push_back(labelInt);
+        rowIds.push_back(rowId);
+        userIds.push_back(uid);
+        userNames.push_back(uname);
+        return labelInt;
+    }
+
+    // uid에 이미 다른 이름의 샘플이 있는지 (새 행이 충돌을 만드는지 판단)
+    bool hasOtherName(int uid, const QString& uname) const {
+        for (size_t i = 0; i < userIds.size(); ++i) {
+            if (userIds[i] == uid && userNames[i] != uname)
+                return true;
+        }
+        return false;
+    }
+
+    // 일부 행을 빼고 충돌 ID를 바꿔 다시 라벨링(DB 재조회 없음, 남은 샘플 순서 유지 → FaceRecognizer::retain과 대응)
+    // 라벨 번호는 유지 → 이전 스냅샷의 라벨→이름 조회가 그대로 유효
+    Gallery rebuilt(const QSet<qint64>& dropRows, const QSet<int>& conflicts) const {
+        Gallery g;
+        g.labelToName = labelToName;
+        g.pairToLabel = pairToLabel;
+        g.nextLabelId = nextLabelId;
+        g.conflictIds = conflicts;
+        g.source = source;
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (!dropRows.contains(rowIds[i]))
+                g.add(rowIds[i], userIds[i], userNames[i], images[i]);
+        }
+        return g;
+    }
+};
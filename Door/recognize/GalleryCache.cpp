@@ -0,0 +1,171 @@
+#include "GalleryCache.h"
+#include "Env.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+const quint32 kMagic = 0x48434743; // "HCGC"
+const int kSide = 128;
+const int kTemplateBytes = kSide * kSide;
+const quint32 kMaxSamples = 10000000; // 손상된 파일 방어
+
+bool readHeader(QDataStream& in, GalleryFingerprint& fp) {
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kGalleryCacheVersion)
+        return false;
+    in >> fp.rows >> fp.maxCreatedAt;
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+bool queryGalleryFingerprint(const QSqlDatabase& db, GalleryFingerprint& out, QString* error) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT COUNT(*), MAX(created_at) FROM face_images") || !q.next()) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    out.rows = q.value(0).toLongLong();
+    out.maxCreatedAt = q.value(1).isNull() ? QString() : q.value(1).toString();
+    return true;
+}
+
+QString galleryCachePath() {
+    const QString env = envOr("GALLERY_CACHE");
+    if (!env.isEmpty())
+        return env;
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty())
+        dir = QDir::tempPath();
+    return QDir(dir).filePath("gallery.cache");
+}
+
+bool saveGalleryCache(const QString& path, const Gallery& gallery, const GalleryFingerprint& fp) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[GalleryCache] open failed:" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    // 1. 헤더(지문)
+    out << kMagic << kGalleryCacheVersion << fp.rows << fp.maxCreatedAt;
+
+    // 2. 라벨 매핑
+    out << (qint32)gallery.nextLabelId << gallery.conflictIds << gallery.labelToName;
+    out << (quint32)gallery.pairToLabel.size();
+    for (auto it = gallery.pairToLabel.cbegin(); it != gallery.pairToLabel.cend(); ++it)
+        out << (qint32)it.key().first << it.key().second << (qint32)it.value();
+
+    // 3. 반영한 DB 상태 (증분 갱신 기준)
+    out << gallery.source.rows << gallery.source.idSum << gallery.source.maxId;
+
+    // 4. 템플릿 (라벨, 행 정보 + 128x128 원시 바이트)
+    out << (quint32)gallery.size();
+    for (int i = 0; i < gallery.size(); ++i) {
+        cv::Mat m = gallery.images[i];
+        if (m.rows != kSide || m.cols != kSide || m.type() != CV_8UC1) {
+            qWarning() << "[GalleryCache] invalid template at" << i;
+            file.cancelWriting();
+            return false;
+        }
+        if (!m.isContinuous())
+            m = m.clone();
+        out << (qint32)gallery.labels[i] << gallery.rowIds[i] << (qint32)gallery.userIds[i] << gallery.userNames[i];
+        out.writeRawData(reinterpret_cast<const char*>(m.data), kTemplateBytes);
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    // 임시 파일에 다 쓴 뒤 교체 → 중간에 죽어도 이전 캐시는 온전
+    return file.commit();
+}
+
+bool peekGalleryCache(const QString& path, GalleryFingerprint& fp) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    return readHeader(in, fp);
+}
+
+bool loadGalleryCache(const QString& path, Gallery& gallery, GalleryFingerprint& fp) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    // 1. 헤더(지문)
+    GalleryFingerprint header;
+    if (!readHeader(in, header)) {
+        qWarning() << "[GalleryCache] incompatible cache:" << path;
+        return false;
+    }
+
+    // 2. 라벨 매핑
+    Gallery g;
+    qint32 nextLabel = 1;
+    quint32 pairs = 0;
+    in >> nextLabel >> g.conflictIds >> g.labelToName >> pairs;
+    if (in.status() != QDataStream::Ok || pairs > kMaxSamples)
+        return false;
+    g.nextLabelId = nextLabel;
+    for (quint32 i = 0; i < pairs; ++i) {
+        qint32 uid = 0, label = 0;
+        QString name;
+        in >> uid >> name >> label;
+        g.pairToLabel.insert(qMakePair((int)uid, name), (int)label);
+    }
+
+    // 3. 반영한 DB 상태
+    in >> g.source.rows >> g.source.idSum >> g.source.maxId;
+
+    // 4. 템플릿
+    quint32 count = 0;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count > kMaxSamples)
+        return false;
+    g.images.reserve(count);
+    g.labels.reserve(count);
+    g.rowIds.reserve(count);
+    g.userIds.reserve(count);
+    g.userNames.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        qint32 label = 0, uid = 0;
+        qint64 rowId = 0;
+        QString uname;
+        in >> label >> rowId >> uid >> uname;
+        cv::Mat m(kSide, kSide, CV_8UC1);
+        if (in.readRawData(reinterpret_cast<char*>(m.data), kTemplateBytes) != kTemplateBytes) {
+            qWarning() << "[GalleryCache] truncated cache:" << path;
+            return false;
+        }
+        g.images.push_back(m);
+        g.labels.push_back(label);
+        g.rowIds.push_back(rowId);
+        g.userIds.push_back(uid);
+        g.userNames.push_back(uname);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    gallery = std::move(g);
+    fp = header;
+    return true;
+}
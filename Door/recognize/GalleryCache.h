@@ -0,0 +1,31 @@
+#pragma once
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include "Gallery.h"
+
+// ---------- DB 스냅샷 지문 ----------
+// face_images 행 수 + 최신 created_at. 같으면 DB 내용이 바뀌지 않은 것으로 보고 캐시를 그대로 사용
+struct GalleryFingerprint {
+    qint64 rows = -1;
+    QString maxCreatedAt;
+
+    bool valid() const { return rows >= 0; }
+    bool operator==(const GalleryFingerprint& o) const { return rows == o.rows && maxCreatedAt == o.maxCreatedAt; }
+    bool operator!=(const GalleryFingerprint& o) const { return !(*this == o); }
+    QString toString() const { return QString("%1 rows, %2").arg(rows).arg(maxCreatedAt.isEmpty() ? "-" : maxCreatedAt); }
+};
+
+// SELECT COUNT(*), MAX(created_at) FROM face_images
+bool queryGalleryFingerprint(const QSqlDatabase& db, GalleryFingerprint& out, QString* error = nullptr);
+
+// ---------- 갤러리 캐시 파일 ----------
+// 전처리 템플릿(gray 128x128) + 행 정보(id, user_id, user_name) + 라벨 매핑 + 지문을 로컬 파일에 저장 → 다음 시작 시 DB 디코딩/전처리 생략
+// 경로: GALLERY_CACHE, 없으면 <캐시 디렉터리>/gallery.cache. 저장은 QSaveFile로 원자적 교체(실패 시 이전 캐시 유지)
+// 템플릿 전처리 방식이 바뀌면 kGalleryCacheVersion을 올려 이전 캐시를 무효화
+constexpr quint32 kGalleryCacheVersion = 3; // 3: 디코딩을 바로 gray(INTER_AREA)로 변경
+
+QString galleryCachePath();
+bool saveGalleryCache(const QString& path, const Gallery& gallery, const GalleryFingerprint& fp);
+bool loadGalleryCache(const QString& path, Gallery& gallery, GalleryFingerprint& fp);
+// 헤더(지문)만 읽기 — 템플릿을 적재하기 전에 유효성 판단
+bool peekGalleryCache(const QString& path, GalleryFingerprint& fp);
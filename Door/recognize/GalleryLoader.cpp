@@ -0,0 +1,248 @@
+#include "GalleryLoader.h"
+#include "Env.h"
+#include "FaceTemplate.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+
+namespace {
+
+quint32 readBe32(const uchar* p) {
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+// 헤더만 보고 영상 크기 추정 (PNG IHDR / JPEG SOFn). 모르면 false
+bool peekImageSize(const QByteArray& data, int& w, int& h) {
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    const int n = data.size();
+    if (n >= 24 && p[0] == 0x89 && p[1] == 'P' && p[2] == 'N' && p[3] == 'G' && std::memcmp(p + 12, "IHDR", 4) == 0) {
+        w = (int)readBe32(p + 16);
+        h = (int)readBe32(p + 20);
+        return w > 0 && h > 0;
+    }
+    if (n >= 4 && p[0] == 0xFF && p[1] == 0xD8) {
+        int i = 2;
+        while (i + 9 < n) {
+            if (p[i] != 0xFF) return false;
+            const uchar marker = p[i + 1];
+            const int len = (p[i + 2] << 8) | p[i + 3];
+            // SOF0..SOF15 (DHT C4, JPG C8, DAC CC 제외)
+            if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+                h = (p[i + 5] << 8) | p[i + 6];
+                w = (p[i + 7] << 8) | p[i + 8];
+                return w > 0 && h > 0;
+            }
+            i += 2 + len;
+        }
+    }
+    return false;
+}
+
+// 축소 후에도 짧은 변이 128 이상인 가장 큰 배율 (JPEG는 DCT 단계에서 축소 → 디코딩 자체가 빨라짐)
+int reducedGrayFlag(const QByteArray& data) {
+    int w = 0, h = 0;
+    if (!peekImageSize(data, w, h))
+        return cv::IMREAD_GRAYSCALE;
+    const int shortSide = std::min(w, h);
+    if (shortSide >= kFaceTemplateSide * 8) return cv::IMREAD_REDUCED_GRAYSCALE_8;
+    if (shortSide >= kFaceTemplateSide * 4) return cv::IMREAD_REDUCED_GRAYSCALE_4;
+    if (shortSide >= kFaceTemplateSide * 2) return cv::IMREAD_REDUCED_GRAYSCALE_2;
+    return cv::IMREAD_GRAYSCALE;
+}
+
+// 행 조회 SELECT: id, user_id, user_name, 템플릿 사용 여부, 값(템플릿 또는 PNG)
+// 버전/크기가 맞는 템플릿이 있으면 face_data는 보내지 않음
+QString faceRowSelect(const QSqlDatabase& db) {
+    if (!hasFaceTemplateColumns(db))
+        return "SELECT id, user_id, user_name, 0, face_data FROM face_images";
+    const QString usable = QString("(template_version = %1 AND LENGTH(face_template) = %2)")
+                               .arg(kFaceTemplateVersion).arg(kFaceTemplateBytes);
+    return QString("SELECT id, user_id, user_name, %1, IF(%1, face_template, face_data) FROM face_images").arg(usable);
+}
+
+void readFaceBlob(const QSqlQuery& q, FaceBlob& b) {
+    b.id = q.value(0).toLongLong();
+    b.userId = q.value(1).toInt();
+    b.userName = q.value(2).toString().trimmed();
+    b.isTemplate = q.value(3).toInt() != 0;
+    b.data = q.value(4).toByteArray();
+}
+
+bool decodeBlob(const FaceBlob& b, cv::Mat& outGray128) {
+    return b.isTemplate ? decodeFaceTemplate(b.data, outGray128) : decodeFaceRow(b.data, outGray128);
+}
+
+} // namespace
+
+bool decodeFaceRow(const QByteArray& data, cv::Mat& outGray128) {
+    if (data.isEmpty())
+        return false;
+
+    // QByteArray 버퍼를 그대로 감싸서 디코딩(복사 없음)
+    const cv::Mat buf(1, (int)data.size(), CV_8U, const_cast<char*>(data.constData()));
+    cv::Mat gray = cv::imdecode(buf, reducedGrayFlag(data)); // DB 이미지를 바로 흑백으로 복원
+    if (gray.empty())
+        return false;
+
+    outGray128 = makeFaceTemplate(gray); // 사이즈 표준화(128x128), 등록 앱의 템플릿과 같은 방식
+    return true;
+}
+
+bool streamGallery(const FaceBlobSource& next, Gallery& out, GalleryLoadStats* stats) {
+    out.clear();
+    QElapsedTimer clock;
+    clock.start();
+
+    const int threads = std::max(1, QThread::idealThreadCount());
+    const int window = std::max(threads, envIntOr("LOADER_WINDOW", threads * 8));
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QSemaphore inFlight(window);
+
+    // 조회 순서대로 보관. deque는 push_back 해도 기존 원소 주소가 유지 → 작업 스레드가 제 행에 직접 기록
+    std::deque<FaceRow> rows;
+    std::atomic<qint64> failed{0};
+    QHash<int, QSet<QString>> namesPerId;
+    qint64 bytes = 0, templates = 0;
+
+    // 1. 조회(이 스레드) ↔ 디코딩(스레드 풀) 파이프라인
+    FaceBlob blob;
+    while (next(blob)) {
+        // 반영한 DB 상태 + ID - 이름 충돌 스캔 (같은 패스)
+        out.source.rows++;
+        out.source.idSum += blob.id;
+        out.source.maxId = std::max(out.source.maxId, blob.id);
+        namesPerId[blob.userId].insert(blob.userName);
+        bytes += blob.data.size();
+
+        rows.push_back(FaceRow{blob.id, blob.userId, blob.userName, cv::Mat()});
+        FaceRow* row = &rows.back();
+
+        // 템플릿은 복사만 하면 되므로 풀에 넘기지 않음
+        if (blob.isTemplate) {
+            if (decodeFaceTemplate(blob.data, row->gray128))
+                templates++;
+            else
+                failed++;
+            blob = FaceBlob();
+            continue;
+        }
+
+        inFlight.acquire(); // 처리 중인 행이 window개면 하나 끝날 때까지 조회 대기
+        pool.start([row, data = std::move(blob.data), &inFlight, &failed]() {
+            if (!decodeFaceRow(data, row->gray128))
+                failed++;
+            inFlight.release();
+        });
+        blob = FaceBlob();
+    }
+    pool.waitForDone();
+
+    // 2. 충돌 ID
+    for (auto it = namesPerId.begin(); it != namesPerId.end(); ++it) {
+        if (it.value().size() > 1) {
+            out.conflictIds.insert(it.key());
+            qWarning() << "[WARN] user_id" << it.key()
+                       << "has multiple names:" << it.value().values();
+        }
+    }
+
+    // 3. 라벨링 (조회 순서 유지)
+    for (const FaceRow& r : rows) {
+        if (!r.gray128.empty())
+            out.add(r.id, r.userId, r.userName, r.gray128);
+    }
+
+    if (stats) {
+        stats->rows = out.source.rows;
+        stats->failed = failed.load();
+        stats->templates = templates;
+        stats->bytes = bytes;
+        stats->ms = clock.nsecsElapsed() / 1e6;
+        stats->threads = threads;
+        stats->window = window;
+    }
+    return true;
+}
+
+bool loadGalleryFromDb(const QSqlDatabase& db, Gallery& out, QString* error, GalleryLoadStats* stats) {
+    // 한 번의 순방향 조회 (버퍼링 없이 한 행씩)
+    QSqlQuery q(db);
+    const QString select = faceRowSelect(db);
+    q.setForwardOnly(true);
+    if (!q.exec(select + " ORDER BY created_at ASC, id ASC")) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+
+    const bool ok = streamGallery([&q](FaceBlob& b) {
+        if (!q.next())
+            return false;
+        readFaceBlob(q, b);
+        return true;
+    }, out, stats);
+
+    // 스트리밍 중 연결이 끊기면 next()가 false → 오류로 처리(부분 갤러리를 쓰지 않음)
+    if (q.lastError().isValid()) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    return ok;
+}
+
+bool queryGallerySource(const QSqlDatabase& db, GallerySource& out, QString* error) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT COUNT(*), COALESCE(SUM(id), 0), COALESCE(MAX(id), 0) FROM face_images") || !q.next()) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    out.rows = q.value(0).toLongLong();
+    out.idSum = q.value(1).toLongLong();
+    out.maxId = q.value(2).toLongLong();
+    return true;
+}
+
+bool fetchFaceRows(const QSqlDatabase& db, qint64 afterId, qint64 upToId, std::vector<FaceRow>& out, QString* error) {
+    out.clear();
+    QSqlQuery q(db);
+    q.prepare(faceRowSelect(db) + " WHERE id > :after AND id <= :upto ORDER BY id ASC");
+    q.bindValue(":after", afterId);
+    q.bindValue(":upto", upToId);
+    if (!q.exec()) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    while (q.next()) {
+        FaceBlob b;
+        readFaceBlob(q, b);
+        FaceRow row{b.id, b.userId, b.userName, cv::Mat()};
+        if (!decodeBlob(b, row.gray128))
+            row.gray128.release();
+        out.push_back(std::move(row));
+    }
+    return true;
+}
+
+bool fetchFaceRowIds(const QSqlDatabase& db, QSet<qint64>& out, QString* error) {
+    out.clear();
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (!q.exec("SELECT id FROM face_images")) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    while (q.next())
+        out.insert(q.value(0).toLongLong());
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include <opencv2/core.hpp>
+#include <functional>
+#include <vector>
+#include "Gallery.h"
+
+// ---------- face_images → 갤러리 ----------
+// DB 행(PNG) 디코딩과 조회를 MainWindow/갤러리 감시 스레드가 함께 사용
+// QSqlDatabase 연결은 만든 스레드에서만 사용할 것
+
+// 디코딩된 DB 행 하나
+struct FaceRow {
+    qint64 id = 0;
+    int userId = 0;
+    QString userName;   // trim
+    cv::Mat gray128;    // 디코딩 실패 시 비어 있음
+};
+
+// 스트리밍 적재 입력 한 행 (blob은 디코딩이 끝나면 해제)
+struct FaceBlob {
+    qint64 id = 0;
+    int userId = 0;
+    QString userName;   // trim
+    QByteArray data;    // isTemplate면 face_template(gray 128x128 원시), 아니면 face_data(PNG/JPEG)
+    bool isTemplate = false;
+};
+
+// 다음 행을 채우고 true, 끝이면 false
+using FaceBlobSource = std::function<bool(FaceBlob& out)>;
+
+struct GalleryLoadStats {
+    qint64 rows = 0;
+    qint64 failed = 0;   // 디코딩 실패
+    qint64 templates = 0; // 전처리 템플릿을 그대로 쓴 행 (나머지는 PNG 디코딩)
+    qint64 bytes = 0;    // blob 총 크기
+    double ms = 0.0;
+    int threads = 0;
+    int window = 0;      // 동시에 처리 중인 최대 행 수
+};
+
+// PNG/JPEG → gray 128x128
+// - QByteArray를 복사하지 않고 그대로 imdecode, 컬러 복원 없이 바로 gray로 디코딩
+// - 원본이 충분히 크면(PNG/JPEG 헤더의 크기) IMREAD_REDUCED_GRAYSCALE_2/4/8로 축소 디코딩
+bool decodeFaceRow(const QByteArray& data, cv::Mat& outGray128);
+
+// 스트리밍 적재: 템플릿 행은 바로 복사, PNG 행만 디코딩. 한 번의 순방향 읽기로 충돌 스캔 + DB 상태 집계, 디코딩은 스레드 풀에서 조회와 겹쳐 실행
+// 처리 중인 행은 window(LOADER_WINDOW, 기본 스레드 수 x 8)개까지만 → blob 메모리 상한
+bool streamGallery(const FaceBlobSource& next, Gallery& out, GalleryLoadStats* stats = nullptr);
+
+// 전체 적재: forward-only 쿼리(QMYSQL은 mysql_use_result로 결과를 서버에서 한 행씩 받음) → streamGallery
+// 템플릿 버전이 맞는 행은 face_data를 전송받지 않음(템플릿 컬럼이 없는 DB면 PNG만 사용)
+bool loadGalleryFromDb(const QSqlDatabase& db, Gallery& out, QString* error = nullptr,
+                       GalleryLoadStats* stats = nullptr);
+
+// SELECT COUNT(*), SUM(id), MAX(id) — 감시 스레드의 변경 확인(가벼운 쿼리)
+bool queryGallerySource(const QSqlDatabase& db, GallerySource& out, QString* error = nullptr);
+
+// afterId < id <= upToId 인 행을 id 순으로 읽어 디코딩(템플릿 우선)
+bool fetchFaceRows(const QSqlDatabase& db, qint64 afterId, qint64 upToId, std::vector<FaceRow>& out,
+                   QString* error = nullptr);
+
+// 현재 남아 있는 id 전체 (삭제 판단용)
+bool fetchFaceRowIds(const QSqlDatabase& db, QSet<qint64>& out, QString* error = nullptr);
@@ -0,0 +1,174 @@
+#include "GalleryWatcher.h"
+#include "DbManager.h"
+#include "Env.h"
+#include "GalleryCache.h"
+#include "GalleryLoader.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <algorithm>
+
+GalleryWatcher::GalleryWatcher(ModelStore* store, QObject* parent)
+    : QThread(parent), store(store), pollMs(std::max(100, envIntOr("GALLERY_POLL_MS", 3000))) {}
+
+GalleryWatcher::~GalleryWatcher() {
+    stop();
+}
+
+void GalleryWatcher::stop() {
+    requestInterruption();
+    wait();
+}
+
+void GalleryWatcher::sleepMs(int ms) {
+    // 종료 요청에 빨리 반응하도록 잘게 나눠 대기
+    for (int left = ms; left > 0 && !isInterruptionRequested(); left -= 100)
+        msleep(std::min(left, 100));
+}
+
+void GalleryWatcher::run() {
+    DbManager db("RecognizeWatcher");
+    bool connected = false;
+    int backoffMs = pollMs;
+
+    while (!isInterruptionRequested()) {
+        // 1. 연결(끊겼으면 재연결, 실패할수록 간격을 늘림: 최대 60초)
+        if (!connected) {
+            connected = db.open();
+            if (!connected) {
+                backoffMs = std::min(backoffMs * 2, 60000);
+                sleepMs(backoffMs);
+                continue;
+            }
+            backoffMs = pollMs;
+        }
+
+        // 2. 변경 확인/반영
+        if (!poll(db)) {
+            db.close();
+            connected = false;
+        }
+        sleepMs(pollMs);
+    }
+    db.close();
+}
+
+bool GalleryWatcher::poll(DbManager& db) {
+    // 1. 집계만 조회 → 현재 스냅샷이 반영한 상태와 같으면 끝
+    GallerySource now;
+    QString err;
+    if (!queryGallerySource(db.database(), now, &err)) {
+        qWarning() << "[GalleryWatcher] query failed:" << err;
+        return false;
+    }
+    const std::shared_ptr<const ModelSnapshot> snap = store->current();
+    const Gallery empty;
+    const Gallery& cur = (snap && snap->gallery) ? *snap->gallery : empty;
+    if (now == cur.source)
+        return true;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    // 2. 새 행 (마지막으로 본 id 이후 ~ 이번 집계의 MAX(id))
+    std::vector<FaceRow> rows;
+    if (now.maxId > cur.source.maxId && !fetchFaceRows(db.database(), cur.source.maxId, now.maxId, rows, &err)) {
+        qWarning() << "[GalleryWatcher] fetch failed:" << err;
+        return false;
+    }
+    GallerySource expect = cur.source;
+    for (const FaceRow& r : rows) {
+        expect.rows++;
+        expect.idSum += r.id;
+    }
+
+    // 3. 삭제 확인: 행 수/id 합이 기대와 다를 때만 남은 id 전체와 비교
+    QSet<qint64> dropped;
+    if (now.rows != expect.rows || now.idSum != expect.idSum) {
+        QSet<qint64> alive;
+        if (!fetchFaceRowIds(db.database(), alive, &err)) {
+            qWarning() << "[GalleryWatcher] id scan failed:" << err;
+            return false;
+        }
+        for (qint64 id : cur.rowIds) {
+            if (!alive.contains(id))
+                dropped.insert(id);
+        }
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                  [&](const FaceRow& r) { return !alive.contains(r.id); }),
+                   rows.end());
+    }
+
+    // 4. ID - 이름 충돌 재계산 (남은 샘플 + 새 행)
+    QHash<int, QSet<QString>> namesPerId;
+    for (int i = 0; i < cur.size(); ++i) {
+        if (!dropped.contains(cur.rowIds[i]))
+            namesPerId[cur.userIds[i]].insert(cur.userNames[i]);
+    }
+    for (const FaceRow& r : rows)
+        namesPerId[r.userId].insert(r.userName);
+    QSet<int> conflicts;
+    for (auto it = namesPerId.cbegin(); it != namesPerId.cend(); ++it) {
+        if (it.value().size() > 1)
+            conflicts.insert(it.key());
+    }
+
+    // 5. 새 갤러리 + 인식기 만들기 (게시된 스냅샷은 건드리지 않음)
+    //    삭제/충돌 변화 없음 → 복제본에 증분 추가
+    //    있으면 → 복제본에서 빠진 샘플만 제거 + 라벨 교체(특징 재계산 없음) 후 증분 추가
+    //    복제/대상 갱신을 지원하지 않는 백엔드(contrib)만 남은 템플릿으로 전체 재학습
+    const bool targeted = !dropped.isEmpty() || conflicts != cur.conflictIds;
+    auto next = std::make_shared<Gallery>(targeted ? cur.rebuilt(dropped, conflicts) : cur);
+
+    std::unique_ptr<FaceRecognizer> rec;
+    if (snap && snap->recognizer && snap->recognizer->sampleCount() == cur.size())
+        rec = snap->recognizer->clone();
+    if (rec && targeted) {
+        std::vector<char> keep(cur.size());
+        for (int i = 0; i < cur.size(); ++i)
+            keep[i] = !dropped.contains(cur.rowIds[i]);
+        if (!rec->retain(keep, next->labels)) // next에는 아직 남은 샘플만 있음 (학습 순서 그대로)
+            rec.reset();
+    }
+
+    std::vector<cv::Mat> addImages;
+    std::vector<int> addLabels;
+    for (const FaceRow& r : rows) {
+        if (r.gray128.empty())
+            continue; // 디코딩 실패 행은 상태(source)에만 반영
+        if (conflicts.contains(r.userId) && !cur.conflictIds.contains(r.userId))
+            qWarning() << "[WARN] user_id" << r.userId << "has multiple names:" << namesPerId.value(r.userId).values();
+        addLabels.push_back(next->add(r.id, r.userId, r.userName, r.gray128));
+        addImages.push_back(r.gray128);
+    }
+    next->source = now;
+
+    bool ok = true;
+    const bool fullRetrain = !rec;
+    if (rec) {
+        ok = rec->update(addImages, addLabels);
+    } else {
+        rec = createFaceRecognizer();
+        if (!next->empty())
+            ok = rec->train(next->images, next->labels);
+    }
+    if (!ok) {
+        qWarning() << "[GalleryWatcher]" << rec->name() << "update failed, keeping current model";
+        return true;
+    }
+
+    // 6. 원자적 교체 → 캐시 갱신
+    const QString mode = fullRetrain ? "전체 재학습" : targeted ? "대상 갱신" : "증분";
+    store->publish(std::move(rec), next);
+    const qint64 ms = clock.elapsed();
+    qDebug().noquote() << QString("[GalleryWatcher] %1: +%2 / -%3 rows → %4 samples (%5 ms)")
+                              .arg(fullRetrain ? "full retrain" : targeted ? "targeted" : "incremental")
+                              .arg(addImages.size()).arg(dropped.size()).arg(next->size()).arg(ms);
+    emit statusChanged(QString("갤러리 갱신(%1): +%2 / -%3, 총 %4장 [%5 ms]")
+                           .arg(mode).arg(addImages.size()).arg(dropped.size()).arg(next->size()).arg(ms));
+
+    GalleryFingerprint fp;
+    if (queryGalleryFingerprint(db.database(), fp) && !saveGalleryCache(galleryCachePath(), *next, fp))
+        qWarning() << "[GalleryCache] save failed:" << galleryCachePath();
+    return true;
+}
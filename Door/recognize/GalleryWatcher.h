@@ -0,0 +1,35 @@
+#pragma once
+#include <QThread>
+#include <QString>
+#include "ModelStore.h"
+
+class DbManager;
+
+// 갤러리 감시 스레드 (재시작 없이 새 등록 반영)
+// - GALLERY_POLL_MS(기본 3000, 0=끔)마다 face_images 집계(COUNT, SUM(id), MAX(id))만 조회
+// - 마지막으로 본 id보다 큰 행만 읽어 디코딩 → 복제한 인식기에 update()(LBPH 히스토그램/NN 갤러리 추가)
+// - 삭제나 ID/이름 충돌 변화가 있으면 복제한 인식기에서 빠진 샘플만 제거 + 라벨 교체(retain, 특징 재계산 없음)
+//   retain/clone을 지원하지 않는 백엔드(contrib)만 메모리의 템플릿으로 전체 재학습(DB 전체 재조회 없음)
+// - 새 스냅샷은 ModelStore::publish()로 원자적 교체, 갤러리 캐시도 갱신
+// - DB 연결이 끊기면 백오프하며 재연결 (연결 전용 이름 "RecognizeWatcher", 이 스레드에서만 사용)
+class GalleryWatcher : public QThread {
+    Q_OBJECT
+public:
+    explicit GalleryWatcher(ModelStore* store, QObject* parent = nullptr);
+    ~GalleryWatcher() override;
+
+    void stop(); // 스레드 종료 요청 + 대기
+
+signals:
+    void statusChanged(const QString& s);
+
+protected:
+    void run() override;
+
+private:
+    bool poll(DbManager& db); // false = DB 오류(재연결 필요)
+    void sleepMs(int ms);
+
+    ModelStore* store = nullptr; // 모델 게시 지점(소유하지 않음)
+    int pollMs = 3000;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+
+// ---------- 지연 히스토그램 ----------
+// 고정 구간(ms) 누적 카운트 + 최소/최대/평균, 근사 백분위(구간 상한)
+// 한 스레드에서만 사용 (시리얼 I/O 스레드)
+class LatencyHistogram {
+public:
+    void add(qint64 ms) {
+        ms = std::max<qint64>(0, ms);
+        size_t i = 0;
+        while (i < kBounds.size() && ms > kBounds[i])
+            ++i;
+        counts[i]++;
+        n++;
+        sum += ms;
+        minMs = n == 1 ? ms : std::min(minMs, ms);
+        maxMs = std::max(maxMs, ms);
+    }
+
+    quint64 count() const { return n; }
+
+    // p(0~1) 백분위가 들어 있는 구간의 상한 (마지막 구간이면 최대값)
+    qint64 percentile(double p) const {
+        if (n == 0)
+            return 0;
+        const quint64 target = std::max<quint64>(1, quint64(p * n + 0.5));
+        quint64 acc = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            acc += counts[i];
+            if (acc >= target)
+                return i < kBounds.size() ? std::min<qint64>(kBounds[i], maxMs) : maxMs;
+        }
+        return maxMs;
+    }
+
+    // "n=12 avg 640 p50<=750 p90<=1000 max 1210 | <=500:3 <=750:6 ..." (빈 구간 생략)
+    QString summary() const {
+        if (n == 0)
+            return "n=0";
+        QStringList buckets;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i] == 0)
+                continue;
+            buckets << (i < kBounds.size() ? QString("<=%1:%2").arg(kBounds[i]).arg(counts[i])
+                                           : QString(">%1:%2").arg(kBounds.back()).arg(counts[i]));
+        }
+        return QString("n=%1 avg %2 min %3 p50<=%4 p90<=%5 max %6 ms | %7")
+            .arg(n).arg(double(sum) / n, 0, 'f', 0).arg(minMs)
+            .arg(percentile(0.5)).arg(percentile(0.9)).arg(maxMs)
+            .arg(buckets.join(' '));
+    }
+
+private:
+    static constexpr std::array<qint64, 12> kBounds{20, 50, 100, 200, 300, 500, 750, 1000, 1500, 2000, 3000, 5000};
+    std::array<quint64, 13> counts{};
+    quint64 n = 0;
+    qint64 sum = 0;
+    qint64 minMs = 0;
+    qint64 maxMs = 0;
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "FrameTypes.h"
+
+// 최신 프레임 1장만 유지하는 슬롯 (단일 생산자 / 다중 소비자)
+// - 생산자(캡처)는 항상 최신 프레임을 게시, 소비자는 항상 가장 최신 프레임을 가져감
+// - 데이터 경로는 락 없음: 슬롯 N개 + 슬롯별 읽기 카운트 + 순번 검증
+//   (cv::Mat 픽셀 버퍼는 참조 카운트로 공유되므로 헤더 복사만 보호하면 됨)
+// - 아무 소비자도 가져가지 않고 덮어쓴 프레임은 droppedCount()로 집계
+// - 대기용 mutex/condvar는 소비자를 재우는 용도로만 사용(데이터 보호 X)
+class LatestFrameSlot {
+public:
+    static constexpr int kSlots = 4; // 소비자 수 + 2 이상이면 생산자가 항상 빈 슬롯을 찾음
+
+    // 생산자 전용
+    void publish(FramePacket pkt) {
+        const int cur = (int)(latest.load() & kIndexMask);
+
+        // 현재 최신 슬롯과 읽는 중인 슬롯을 피해 쓸 슬롯 선택
+        for (int n = 1; n <= kSlots; ++n) {
+            const int i = (cur + n) % kSlots;
+            if (i == cur && latest.load() != 0)
+                continue;
+            Slot& s = slots[i];
+            s.seq.store(0);                 // 쓰는 중 표시 (이후 새 독자는 진입 실패)
+            if (s.readers.load() != 0)      // 이미 진입한 독자가 있으면 다른 슬롯
+                continue;
+
+            const quint64 seq = pkt.seq;
+            s.pkt = std::move(pkt);
+            s.taken.store(false);
+            s.seq.store(seq);
+
+            // 이전 최신 프레임을 아무도 가져가지 않았다면 버려진 것으로 집계
+            const std::uint64_t prev = latest.exchange((seq << kIndexBits) | (std::uint64_t)i);
+            if (prev != 0 && !slots[prev & kIndexMask].taken.load())
+                dropped.fetch_add(1);
+            published.fetch_add(1);
+
+            { std::lock_guard<std::mutex> lock(waitMtx); }
+            waitCv.notify_all();
+            return;
+        }
+        // 모든 슬롯이 읽히는 중(소비자 과다) → 이번 프레임 버림
+        dropped.fetch_add(1);
+    }
+
+    // afterSeq보다 새로운 최신 프레임이 있으면 복사(헤더만)하고 true
+    bool readLatest(FramePacket& out, quint64 afterSeq = 0) {
+        for (;;) {
+            const std::uint64_t l = latest.load();
+            const quint64 seq = l >> kIndexBits;
+            if (l == 0 || seq <= afterSeq)
+                return false;
+
+            Slot& s = slots[l & kIndexMask];
+            s.readers.fetch_add(1);
+            if (s.seq.load() == seq) {      // 생산자가 덮어쓰기 전에 진입 성공
+                out = s.pkt;
+                s.taken.store(true);
+                s.readers.fetch_sub(1);
+                return true;
+            }
+            s.readers.fetch_sub(1);         // 그 사이 덮어써짐 → 새 최신으로 재시도
+        }
+    }
+
+    // 새 프레임이 올 때까지 최대 timeoutMs 대기 후 readLatest
+    bool waitLatest(FramePacket& out, quint64 afterSeq, int timeoutMs) {
+        if (readLatest(out, afterSeq))
+            return true;
+        {
+            std::unique_lock<std::mutex> lock(waitMtx);
+            waitCv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] {
+                return closed.load() || (latest.load() >> kIndexBits) > afterSeq;
+            });
+        }
+        return readLatest(out, afterSeq);
+    }
+
+    // 대기 중인 소비자 깨우기(종료 시)
+    void close() {
+        closed.store(true);
+        { std::lock_guard<std::mutex> lock(waitMtx); }
+        waitCv.notify_all();
+    }
+
+    // 재시작용 (생산자/소비자 모두 멈춘 상태에서만 호출)
+    void reset() {
+        for (auto& s : slots) {
+            s.pkt = FramePacket();
+            s.seq.store(0);
+            s.taken.store(false);
+        }
+        latest.store(0);
+        closed.store(false);
+    }
+
+    quint64 latestSeq() const { return latest.load() >> kIndexBits; }
+    quint64 publishedCount() const { return published.load(); }
+    quint64 droppedCount() const { return dropped.load(); }
+
+private:
+    static constexpr int kIndexBits = 8;
+    static constexpr std::uint64_t kIndexMask = (1u << kIndexBits) - 1;
+
+    struct Slot {
+        FramePacket pkt;
+        std::atomic<quint64> seq{0};   // 0 = 비었거나 쓰는 중
+        std::atomic<int> readers{0};
+        std::atomic<bool> taken{false};
+    };
+
+    Slot slots[kSlots];
+    std::atomic<std::uint64_t> latest{0}; // (seq << 8) | slotIndex, 0이면 아직 없음
+    std::atomic<quint64> published{0};
+    std::atomic<quint64> dropped{0};
+    std::atomic<bool> closed{false};
+
+    std::mutex waitMtx;
+    std::condition_variable waitCv;
+};
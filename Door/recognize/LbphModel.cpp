@@ -0,0 +1,576 @@
+#include "LbphModel.h"
+#include "ShardedNearest.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LBPH_HAS_AVX2 1
+#else
+#define LBPH_HAS_AVX2 0
+#endif
+
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define LBPH_HAS_NEON 1
+#else
+#define LBPH_HAS_NEON 0
+#endif
+
+namespace {
+
+const int kBlock = 1024; // chi-square 조기 중단 검사 간격(bin)
+
+// ---------- LBP 표본점 (radius 1, 8 neighbors) ----------
+// contrib elbp: n번째 표본점 (x, y) = (cos(2πn/8), -sin(2πn/8)), 비트 n = (보간값 >= 중심)
+//  짝수 n(→, ↑, ←, ↓)은 화소 중심과 겹쳐 정수 비교로 충분
+//  홀수 n(대각)은 주변 2x2 화소 쌍선형 보간 — 가중치를 contrib와 같은 float 연산으로 컴파일 시 계산
+struct Bilinear {
+    float w1, w2, w3, w4; // (좌상, 우상, 좌하, 우하) 화소 가중치
+};
+
+constexpr float kDiagOffset = 0.70710677f; // float(cos(π/4))
+
+constexpr Bilinear bilinear(float tx, float ty) {
+    return {(1.0f - tx) * (1.0f - ty), tx * (1.0f - ty), (1.0f - tx) * ty, tx * ty};
+}
+
+constexpr Bilinear kDiag[4] = {
+    bilinear(kDiagOffset, 1.0f - kDiagOffset),        // n=1 : 오른쪽 위
+    bilinear(1.0f - kDiagOffset, 1.0f - kDiagOffset), // n=3 : 왼쪽 위
+    bilinear(1.0f - kDiagOffset, kDiagOffset),        // n=5 : 왼쪽 아래
+    bilinear(kDiagOffset, kDiagOffset),               // n=7 : 오른쪽 아래
+};
+
+// ---------- uniform LBP 매핑 (0/1 전이 2회 이하 58개 패턴 → 0..57, 나머지 → 58) ----------
+constexpr int transitions(int code) {
+    int t = 0;
+    for (int b = 0; b < 8; ++b)
+        t += ((code >> b) & 1) != ((code >> ((b + 1) & 7)) & 1);
+    return t;
+}
+
+struct UniformMap {
+    uchar bin[256];
+};
+
+constexpr UniformMap makeUniformMap() {
+    UniformMap m{};
+    int next = 0;
+    for (int c = 0; c < 256; ++c)
+        m.bin[c] = (uchar)(transitions(c) <= 2 ? next++ : LbphModel::kUniformBins - 1);
+    return m;
+}
+
+constexpr UniformMap kUniform = makeUniformMap();
+static_assert(kUniform.bin[255] == LbphModel::kUniformBins - 2, "uniform LBP(P=8)는 58개 패턴");
+
+// 양자화 배율: 셀 전체(정규화 합 1.0)를 정수 최대값에 대응
+constexpr double kScale16 = 65535.0;
+constexpr double kScale8 = 255.0;
+
+inline float interp(float s1, float s2, float s3, float s4, const Bilinear& w) {
+    return w.w1 * s1 + w.w2 * s2 + w.w3 * s3 + w.w4 * s4;
+}
+
+// ---------- LBP 한 행 (스칼라) ----------
+// up/mid/dn: 원본 y-1, y, y+1 행, dst[x-1] = 원본 x열 화소의 코드 (x = from..count)
+void lbpRowScalar(const uchar* up, const uchar* mid, const uchar* dn, uchar* dst, int from, int count) {
+    for (int x = from; x <= count; ++x) {
+        const float c = mid[x];
+        int code = 0;
+        code |= (mid[x + 1] >= mid[x]) << 0;
+        code |= (interp(up[x], up[x + 1], mid[x], mid[x + 1], kDiag[0]) >= c) << 1;
+        code |= (up[x] >= mid[x]) << 2;
+        code |= (interp(up[x - 1], up[x], mid[x - 1], mid[x], kDiag[1]) >= c) << 3;
+        code |= (mid[x - 1] >= mid[x]) << 4;
+        code |= (interp(mid[x - 1], mid[x], dn[x - 1], dn[x], kDiag[2]) >= c) << 5;
+        code |= (dn[x] >= mid[x]) << 6;
+        code |= (interp(mid[x], mid[x + 1], dn[x], dn[x + 1], kDiag[3]) >= c) << 7;
+        dst[x - 1] = (uchar)code;
+    }
+}
+
+// ---------- chi-square (스칼라) ----------
+double chiScalar(const float* a, const float* b, int n, double bound) {
+    double total = 0.0;
+    for (int off = 0; off < n; off += kBlock) {
+        const int end = std::min(n, off + kBlock);
+        for (int i = off; i < end; ++i) {
+            const double d = (double)a[i] - b[i];
+            const double s = (double)a[i] + b[i];
+            if (s > DBL_EPSILON)
+                total += d * d / s;
+        }
+        if (2.0 * total > bound)
+            return 2.0 * total;
+    }
+    return 2.0 * total;
+}
+
+// ---------- 양자화 chi-square (스칼라, 정수 단위로 누적 후 1/scale) ----------
+template <typename T>
+double chiQuantScalar(const T* a, const T* b, int n, double bound, double scale) {
+    const double k = 2.0 / scale;
+    double total = 0.0;
+    for (int off = 0; off < n; off += kBlock) {
+        const int end = std::min(n, off + kBlock);
+        for (int i = off; i < end; ++i) {
+            const int sum = (int)a[i] + b[i];
+            if (sum > 0) {
+                const double d = (int)a[i] - (int)b[i];
+                total += d * d / sum;
+            }
+        }
+        if (k * total > bound)
+            return k * total;
+    }
+    return k * total;
+}
+
+#if LBPH_HAS_AVX2
+__attribute__((target("avx2")))
+inline __m256 load8(const uchar* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+__attribute__((target("avx2")))
+inline __m256 interp8(__m256 s1, __m256 s2, __m256 s3, __m256 s4, const Bilinear& w) {
+    // 스칼라와 같은 순서((w1*s1 + w2*s2) + w3*s3) + w4*s4, FMA 없이 → 코드가 스칼라 경로와 일치
+    __m256 t = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(w.w1), s1), _mm256_mul_ps(_mm256_set1_ps(w.w2), s2));
+    t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(w.w3), s3));
+    return _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(w.w4), s4));
+}
+
+__attribute__((target("avx2")))
+inline __m256i bit8(__m256 v, __m256 c, int bit) {
+    return _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(v, c, _CMP_GE_OQ)), _mm256_set1_epi32(bit));
+}
+
+// ---------- LBP 한 행 (AVX2: 8화소 동시, 3x3 이웃을 float 벡터로) ----------
+__attribute__((target("avx2")))
+void lbpRowAvx2(const uchar* up, const uchar* mid, const uchar* dn, uchar* dst, int count) {
+    int x = 1;
+    for (; x + 7 <= count; x += 8) { // 읽기 범위 x-1 .. x+8 (≤ count+1, 행 안쪽)
+        const __m256 u0 = load8(up + x - 1),  u1 = load8(up + x),  u2 = load8(up + x + 1);
+        const __m256 m0 = load8(mid + x - 1), m1 = load8(mid + x), m2 = load8(mid + x + 1);
+        const __m256 d0 = load8(dn + x - 1),  d1 = load8(dn + x),  d2 = load8(dn + x + 1);
+
+        __m256i code = bit8(m2, m1, 1);
+        code = _mm256_or_si256(code, bit8(interp8(u1, u2, m1, m2, kDiag[0]), m1, 2));
+        code = _mm256_or_si256(code, bit8(u1, m1, 4));
+        code = _mm256_or_si256(code, bit8(interp8(u0, u1, m0, m1, kDiag[1]), m1, 8));
+        code = _mm256_or_si256(code, bit8(m0, m1, 16));
+        code = _mm256_or_si256(code, bit8(interp8(m0, m1, d0, d1, kDiag[2]), m1, 32));
+        code = _mm256_or_si256(code, bit8(d1, m1, 64));
+        code = _mm256_or_si256(code, bit8(interp8(m1, m2, d1, d2, kDiag[3]), m1, 128));
+
+        // i32 x8 → u8 x8
+        const __m128i w16 = _mm_packus_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x - 1), _mm_packus_epi16(w16, w16));
+    }
+    lbpRowScalar(up, mid, dn, dst, x, count);
+}
+
+// ---------- chi-square (AVX2: 블록 단위 float 누적 → double 합산) ----------
+__attribute__((target("avx2")))
+double chiAvx2(const float* a, const float* b, int n, double bound) {
+    const __m256 eps = _mm256_set1_ps((float)DBL_EPSILON);
+    double total = 0.0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int i = off; i < off + kBlock; i += 8) {
+            const __m256 va = _mm256_loadu_ps(a + i);
+            const __m256 vb = _mm256_loadu_ps(b + i);
+            const __m256 d = _mm256_sub_ps(va, vb);
+            const __m256 s = _mm256_add_ps(va, vb);
+            // 두 bin이 모두 0이면 0/0 → 마스크로 제거
+            const __m256 q = _mm256_div_ps(_mm256_mul_ps(d, d), s);
+            acc = _mm256_add_ps(acc, _mm256_and_ps(q, _mm256_cmp_ps(s, eps, _CMP_GT_OQ)));
+        }
+        __m128 h = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+        h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 1));
+        total += _mm_cvtss_f32(h);
+        if (2.0 * total > bound)
+            return 2.0 * total;
+    }
+    if (off < n)
+        total += 0.5 * chiScalar(a + off, b + off, n - off, DBL_MAX);
+    return 2.0 * total;
+}
+
+__attribute__((target("avx2")))
+inline __m256 lanes8(const std::uint8_t* p) {
+    return load8(p);
+}
+
+__attribute__((target("avx2")))
+inline __m256 lanes8(const std::uint16_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+
+// ---------- 양자화 chi-square (AVX2: u8/u16 → i32 → float 8레인) ----------
+template <typename T>
+__attribute__((target("avx2")))
+double chiQuantAvx2(const T* a, const T* b, int n, double bound, double scale) {
+    const double k = 2.0 / scale;
+    const __m256 zero = _mm256_setzero_ps();
+    double total = 0.0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int i = off; i < off + kBlock; i += 8) {
+            const __m256 va = lanes8(a + i);
+            const __m256 vb = lanes8(b + i);
+            const __m256 d = _mm256_sub_ps(va, vb);
+            const __m256 s = _mm256_add_ps(va, vb);
+            const __m256 q = _mm256_div_ps(_mm256_mul_ps(d, d), s);
+            acc = _mm256_add_ps(acc, _mm256_and_ps(q, _mm256_cmp_ps(s, zero, _CMP_GT_OQ)));
+        }
+        __m128 h = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+        h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 1));
+        total += _mm_cvtss_f32(h);
+        if (k * total > bound)
+            return k * total;
+    }
+    if (off < n)
+        total += chiQuantScalar(a + off, b + off, n - off, DBL_MAX, scale) / k;
+    return k * total;
+}
+
+bool cpuHasAvx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+#endif
+
+#if LBPH_HAS_NEON
+// ---------- chi-square (NEON, aarch64: vdivq_f32) ----------
+double chiNeon(const float* a, const float* b, int n, double bound) {
+    const float32x4_t eps = vdupq_n_f32((float)DBL_EPSILON);
+    double total = 0.0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int i = off; i < off + kBlock; i += 4) {
+            const float32x4_t va = vld1q_f32(a + i);
+            const float32x4_t vb = vld1q_f32(b + i);
+            const float32x4_t d = vsubq_f32(va, vb);
+            const float32x4_t s = vaddq_f32(va, vb);
+            const float32x4_t q = vdivq_f32(vmulq_f32(d, d), s);
+            const uint32x4_t m = vcgtq_f32(s, eps);
+            acc = vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(q), m)));
+        }
+        total += vaddvq_f32(acc);
+        if (2.0 * total > bound)
+            return 2.0 * total;
+    }
+    if (off < n)
+        total += 0.5 * chiScalar(a + off, b + off, n - off, DBL_MAX);
+    return 2.0 * total;
+}
+
+inline float32x4x2_t lanesNeon(const std::uint8_t* p) {
+    const uint16x8_t w = vmovl_u8(vld1_u8(p));
+    return {{vcvtq_f32_u32(vmovl_u16(vget_low_u16(w))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)))}};
+}
+
+inline float32x4x2_t lanesNeon(const std::uint16_t* p) {
+    const uint16x8_t w = vld1q_u16(p);
+    return {{vcvtq_f32_u32(vmovl_u16(vget_low_u16(w))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)))}};
+}
+
+inline float32x4_t chiLanesNeon(float32x4_t acc, float32x4_t va, float32x4_t vb) {
+    const float32x4_t d = vsubq_f32(va, vb);
+    const float32x4_t s = vaddq_f32(va, vb);
+    const float32x4_t q = vdivq_f32(vmulq_f32(d, d), s);
+    const uint32x4_t m = vcgtq_f32(s, vdupq_n_f32(0.0f));
+    return vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(q), m)));
+}
+
+// ---------- 양자화 chi-square (NEON: u8/u16 → u32 → float 4레인 x2) ----------
+template <typename T>
+double chiQuantNeon(const T* a, const T* b, int n, double bound, double scale) {
+    const double k = 2.0 / scale;
+    double total = 0.0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int i = off; i < off + kBlock; i += 8) {
+            const float32x4x2_t va = lanesNeon(a + i);
+            const float32x4x2_t vb = lanesNeon(b + i);
+            acc = chiLanesNeon(acc, va.val[0], vb.val[0]);
+            acc = chiLanesNeon(acc, va.val[1], vb.val[1]);
+        }
+        total += vaddvq_f32(acc);
+        if (k * total > bound)
+            return k * total;
+    }
+    if (off < n)
+        total += chiQuantScalar(a + off, b + off, n - off, DBL_MAX, scale) / k;
+    return k * total;
+}
+#endif
+
+template <typename T>
+double chiQuant(const T* a, const T* b, int n, double bound, double scale, LbphModel::Kernel k) {
+    if (k == LbphModel::Kernel::Auto) {
+#if LBPH_HAS_AVX2
+        if (cpuHasAvx2()) return chiQuantAvx2(a, b, n, bound, scale);
+#endif
+#if LBPH_HAS_NEON
+        return chiQuantNeon(a, b, n, bound, scale);
+#endif
+    }
+    return chiQuantScalar(a, b, n, bound, scale);
+}
+
+void lbpRow(const uchar* up, const uchar* mid, const uchar* dn, uchar* dst, int count, LbphModel::Kernel k) {
+#if LBPH_HAS_AVX2
+    if (k == LbphModel::Kernel::Auto && cpuHasAvx2()) {
+        lbpRowAvx2(up, mid, dn, dst, count);
+        return;
+    }
+#endif
+    (void)k;
+    lbpRowScalar(up, mid, dn, dst, 1, count);
+}
+
+// ---------- 셀 히스토그램 카운트 ----------
+// LBP 코드를 한 행씩 계산해 셀(8x8)별로 센 뒤, 셀 한 줄이 끝날 때마다 store(gy, count[8 * bins], 셀 화소 수) 호출
+// map이 있으면 코드 → bin 매핑(uniform), 없으면 코드 그대로 256 bin
+template <typename StoreRow>
+bool countCells(const cv::Mat& gray, const uchar* map, int bins, LbphModel::Kernel k, StoreRow store) {
+    const int grid = LbphModel::kGrid;
+    if (gray.type() != CV_8UC1 || gray.rows < grid + 2 || gray.cols < grid + 2)
+        return false;
+
+    // LBP 영상은 (rows-2) x (cols-2), 셀 크기는 contrib와 같이 내림(나머지 행/열은 버림)
+    const int cellW = (gray.cols - 2) / grid;
+    const int cellH = (gray.rows - 2) / grid;
+    const int usedCols = cellW * grid;
+
+    cv::AutoBuffer<uchar> codes(usedCols + 8);
+    // 셀 한 줄 카운터 2벌: 같은 코드가 연달아 나올 때 store→load 의존을 나눔
+    std::uint32_t bank[2][LbphModel::kGrid * LbphModel::kBins];
+
+    for (int gy = 0; gy < grid; ++gy) {
+        std::memset(bank, 0, sizeof(bank));
+        for (int r = 0; r < cellH; ++r) {
+            const int y = gy * cellH + r + 1; // 원본 행 (LBP 행 + radius)
+            uchar* c = codes.data();
+            lbpRow(gray.ptr<uchar>(y - 1), gray.ptr<uchar>(y), gray.ptr<uchar>(y + 1), c, usedCols, k);
+            if (map) {
+                for (int i = 0; i < usedCols; ++i)
+                    c[i] = map[c[i]];
+            }
+            for (int gx = 0; gx < grid; ++gx) {
+                const uchar* cc = c + gx * cellW;
+                std::uint32_t* b0 = bank[0] + gx * bins;
+                std::uint32_t* b1 = bank[1] + gx * bins;
+                int i = 0;
+                for (; i + 1 < cellW; i += 2) {
+                    b0[cc[i]]++;
+                    b1[cc[i + 1]]++;
+                }
+                if (i < cellW)
+                    b0[cc[i]]++;
+            }
+        }
+        for (int i = 0; i < grid * bins; ++i)
+            bank[0][i] += bank[1][i];
+        store(gy, bank[0], cellW * cellH);
+    }
+    return true;
+}
+
+} // namespace
+
+const char* LbphModel::kernelName() {
+#if LBPH_HAS_AVX2
+    if (cpuHasAvx2()) return "avx2";
+#endif
+#if LBPH_HAS_NEON
+    return "neon";
+#endif
+    return "scalar";
+}
+
+double LbphModel::chiSquare(const float* a, const float* b, int n, double bound, Kernel k) {
+    if (k == Kernel::Auto) {
+#if LBPH_HAS_AVX2
+        if (cpuHasAvx2()) return chiAvx2(a, b, n, bound);
+#endif
+#if LBPH_HAS_NEON
+        return chiNeon(a, b, n, bound);
+#endif
+    }
+    return chiScalar(a, b, n, bound);
+}
+
+double LbphModel::chiSquare(const std::uint16_t* a, const std::uint16_t* b, int n, double bound, Kernel k) {
+    return chiQuant(a, b, n, bound, kScale16, k);
+}
+
+double LbphModel::chiSquare(const std::uint8_t* a, const std::uint8_t* b, int n, double bound, Kernel k) {
+    return chiQuant(a, b, n, bound, kScale8, k);
+}
+
+const char* LbphModel::storageName(Storage s) {
+    switch (s) {
+    case Storage::Uniform16: return "u16";
+    case Storage::Uniform8:  return "u8";
+    default:                 return "f32";
+    }
+}
+
+int LbphModel::dimOf(Storage s) {
+    return s == Storage::Float32 ? kDim : kGrid * kGrid * kUniformBins;
+}
+
+size_t LbphModel::elemSizeOf(Storage s) {
+    switch (s) {
+    case Storage::Uniform16: return sizeof(std::uint16_t);
+    case Storage::Uniform8:  return sizeof(std::uint8_t);
+    default:                 return sizeof(float);
+    }
+}
+
+double LbphModel::distance(const uchar* a, const uchar* b, double bound) const {
+    switch (store) {
+    case Storage::Uniform16:
+        return chiSquare(reinterpret_cast<const std::uint16_t*>(a), reinterpret_cast<const std::uint16_t*>(b), dim(), bound, kernel);
+    case Storage::Uniform8:
+        return chiSquare(reinterpret_cast<const std::uint8_t*>(a), reinterpret_cast<const std::uint8_t*>(b), dim(), bound, kernel);
+    default:
+        return chiSquare(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b), dim(), bound, kernel);
+    }
+}
+
+bool LbphModel::histogram(const cv::Mat& gray, float* out, Kernel k) {
+    return countCells(gray, nullptr, kBins, k, [&](int gy, const std::uint32_t* count, int area) {
+        const double inv = 1.0 / area;
+        float* dst = out + gy * kGrid * kBins;
+        for (int i = 0; i < kGrid * kBins; ++i)
+            dst[i] = (float)(count[i] * inv);
+    });
+}
+
+bool LbphModel::encode(const cv::Mat& gray, Storage s, void* out, Kernel k) {
+    if (s == Storage::Float32)
+        return histogram(gray, static_cast<float*>(out), k);
+
+    // uniform 59 bin, 셀 화소 수 대비 비율을 정수로 양자화(반올림)
+    const int row = kGrid * kUniformBins;
+    if (s == Storage::Uniform16) {
+        std::uint16_t* dst = static_cast<std::uint16_t*>(out);
+        return countCells(gray, kUniform.bin, kUniformBins, k, [&](int gy, const std::uint32_t* count, int area) {
+            const double scale = kScale16 / area;
+            for (int i = 0; i < row; ++i)
+                dst[gy * row + i] = (std::uint16_t)std::lround(count[i] * scale);
+        });
+    }
+    std::uint8_t* dst = static_cast<std::uint8_t*>(out);
+    return countCells(gray, kUniform.bin, kUniformBins, k, [&](int gy, const std::uint32_t* count, int area) {
+        const double scale = kScale8 / area;
+        for (int i = 0; i < row; ++i)
+            dst[gy * row + i] = (std::uint8_t)std::lround(count[i] * scale);
+    });
+}
+
+LbphModel::LbphModel(const LbphModel& o)
+    : store(o.store), hists(o.hists.clone()), labels(o.labels), kernel(o.kernel), parallel(o.parallel) {}
+
+LbphModel& LbphModel::operator=(const LbphModel& o) {
+    if (this != &o) {
+        store = o.store;
+        hists = o.hists.clone();
+        labels = o.labels;
+        kernel = o.kernel;
+        parallel = o.parallel;
+    }
+    return *this;
+}
+
+void LbphModel::clear() {
+    hists.release();
+    labels.clear();
+}
+
+bool LbphModel::train(const std::vector<cv::Mat>& images, const std::vector<int>& labels_) {
+    clear();
+    return update(images, labels_);
+}
+
+bool LbphModel::update(const std::vector<cv::Mat>& images, const std::vector<int>& labels_) {
+    const int m = (int)std::min(images.size(), labels_.size());
+    if (m == 0)
+        return true;
+
+    // 샘플별 히스토그램을 병렬 계산 (서로 다른 행에 쓰므로 잠금 불필요)
+    const int type = store == Storage::Float32 ? CV_32F : store == Storage::Uniform16 ? CV_16U : CV_8U;
+    cv::Mat batch(m, dim(), type);
+    std::atomic<bool> ok{true};
+    cv::parallel_for_(cv::Range(0, m), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i) {
+            if (!encode(images[i], store, batch.ptr<uchar>(i), kernel))
+                ok = false;
+        }
+    });
+    if (!ok)
+        return false;
+
+    hists.push_back(batch);
+    labels.insert(labels.end(), labels_.begin(), labels_.begin() + m);
+    return true;
+}
+
+bool LbphModel::retain(const std::vector<char>& keep, const std::vector<int>& labels_) {
+    const int kept = (int)std::count_if(keep.begin(), keep.end(), [](char k) { return k != 0; });
+    if ((int)keep.size() != size() || (int)labels_.size() != kept)
+        return false;
+    if (kept == 0) {
+        clear();
+        return true;
+    }
+
+    // 남은 행만 새 연속 행렬로 복사 (복제본에서 호출 → 게시된 모델 버퍼는 그대로)
+    if (kept < size()) {
+        cv::Mat next(kept, dim(), hists.type());
+        for (int i = 0, j = 0; i < size(); ++i) {
+            if (keep[i])
+                hists.row(i).copyTo(next.row(j++));
+        }
+        hists = next;
+    }
+    labels = labels_;
+    return true;
+}
+
+bool LbphModel::predict(const cv::Mat& gray, int& outLabel, double& outDist) const {
+    if (labels.empty())
+        return false;
+
+    float query[kDim]; // 가장 큰 형식(Float32) 크기, 양자화 형식은 앞부분만 사용
+    if (!encode(gray, store, query, kernel))
+        return false;
+
+    const uchar* q = reinterpret_cast<const uchar*>(query);
+    int bestIndex = -1;
+    double bestDist = 0.0;
+    if (!nearestSharded<double>(size(), parallel, [&](int i, double bound) {
+            return distance(q, hists.ptr<uchar>(i), bound);
+        }, bestIndex, bestDist))
+        return false;
+
+    outLabel = labels[bestIndex];
+    outDist = bestDist;
+    return true;
+}
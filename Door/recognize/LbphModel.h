@@ -0,0 +1,80 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// 내장 LBPH 엔진 (opencv_contrib 없이 동작)
+// - 파라미터 고정: radius 1, neighbors 8, grid 8x8 → contrib LBPHFaceRecognizer::create(1, 8, 8, 8, ...)와 동일
+// - LBP 코드: contrib elbp와 같은 원형 표본점/쌍선형 가중치(constexpr 표), 한 행씩 SIMD로 8화소 동시 계산
+// - 비교: chi-square(HISTCMP_CHISQR_ALT) SIMD 커널, 블록마다 부분합 조기 중단
+// - 학습: 샘플별 히스토그램을 cv::parallel_for_로 병렬 계산, 갤러리는 N x dim 연속 행렬
+//
+// 저장 형식 (샘플당 메모리)
+//  Float32   : 셀마다 256 bin float, 셀 화소 수로 정규화 (contrib와 동일 점수)   16384 x 4B = 64 KB
+//  Uniform16 : uniform LBP 59 bin(비균일 패턴은 1 bin), 16비트 양자화             3776 x 2B ≈ 7.4 KB
+//  Uniform8  : uniform LBP 59 bin, 8비트 양자화                                 3776 x 1B ≈ 3.7 KB
+//  양자화 형식은 정수 그대로 비교하고 1/scale을 곱해 Float32와 같은 척도(정규화 히스토그램)로 돌려줌
+class LbphModel {
+public:
+    static constexpr int kGrid = 8;
+    static constexpr int kBins = 256;
+    static constexpr int kUniformBins = 59;
+    static constexpr int kDim = kGrid * kGrid * kBins;
+
+    enum class Kernel { Auto, Scalar };
+    enum class Storage { Float32, Uniform16, Uniform8 };
+
+    explicit LbphModel(Storage s = Storage::Float32) : store(s) {}
+    // 복사 시 히스토그램 행렬도 깊은 복사 (증분 갱신 복제본이 게시된 모델과 버퍼를 공유하지 않도록)
+    LbphModel(const LbphModel& o);
+    LbphModel& operator=(const LbphModel& o);
+    LbphModel(LbphModel&&) = default;
+    LbphModel& operator=(LbphModel&&) = default;
+
+    void clear();
+    // 전체 학습(기존 내용 대체) / 증분 학습(추가)
+    bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels);
+    bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels);
+    // keep[i]가 0인 샘플 행 제거 + 남은 샘플 라벨 교체 (히스토그램 재계산 없음)
+    bool retain(const std::vector<char>& keep, const std::vector<int>& labels);
+
+    int size() const { return (int)labels.size(); }
+    bool empty() const { return labels.empty(); }
+
+    Storage storage() const { return store; }
+    int dim() const { return dimOf(store); }
+    size_t bytesPerSample() const { return (size_t)dim() * elemSizeOf(store); }
+
+    // 가장 가까운 샘플의 라벨과 chi-square 거리 (contrib predict의 confidence와 같은 척도)
+    bool predict(const cv::Mat& gray, int& outLabel, double& outDist) const;
+
+    // 벤치마크용: 커널/병렬 여부 강제
+    void setKernel(Kernel k) { kernel = k; }
+    void setParallel(bool on) { parallel = on; }
+
+    // 현재 CPU에서 선택되는 커널 이름 ("avx2" / "neon" / "scalar")
+    static const char* kernelName();
+    static const char* storageName(Storage s);
+    static int dimOf(Storage s);
+    static size_t elemSizeOf(Storage s);
+
+    // 공간 히스토그램 계산 (gray CV_8UC1, 최소 10x10) → out[kDim] (Float32 형식)
+    static bool histogram(const cv::Mat& gray, float* out, Kernel k = Kernel::Auto);
+    // 저장 형식에 맞는 템플릿 계산 → out[dimOf(s) * elemSizeOf(s) 바이트]
+    static bool encode(const cv::Mat& gray, Storage s, void* out, Kernel k = Kernel::Auto);
+
+    // chi-square 거리 (2 * Σ (a-b)^2 / (a+b)), 부분합이 bound를 넘으면 즉시 반환(반환값 > bound)
+    static double chiSquare(const float* a, const float* b, int n, double bound, Kernel k = Kernel::Auto);
+    // 양자화 템플릿끼리 chi-square (정수 그대로 계산, 결과에 1/scale 적용)
+    static double chiSquare(const std::uint16_t* a, const std::uint16_t* b, int n, double bound, Kernel k = Kernel::Auto);
+    static double chiSquare(const std::uint8_t* a, const std::uint8_t* b, int n, double bound, Kernel k = Kernel::Auto);
+
+private:
+    double distance(const uchar* a, const uchar* b, double bound) const;
+
+    Storage store;
+    cv::Mat hists;            // N x dim, CV_32F / CV_16U / CV_8U (연속)
+    std::vector<int> labels;
+    Kernel kernel = Kernel::Auto;
+    bool parallel = true;
+};
@@ -1,599 +1,474 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
+#include "CaptureWorker.h"
+#include "RecognizeWorker.h"
+#include "GalleryWatcher.h"
+#include "ModelLoader.h"
+#include "SerialLink.h"
+#include "Env.h"
+#include "FrameView.h"
 #include <QDir>
 #include <QCoreApplication>
 #include <QPainter>
-#include <QFont>
-#include <QFontDatabase>
 #include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
 
 // ---------- 생성/소멸 ----------
+// 오래 걸리는 단계(DB/학습, 시리얼 탐색, 카메라 열기)는 모두 백그라운드에서 동시에 진행
+// → 창과 미리보기는 바로 뜨고, 모델은 준비되는 대로 원자적으로 교체(그 전까지 "모델 로딩 중")
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow) {
     // 1. UI 준비
+    const qint64 t = startup.now();
     ui->setupUi(this);
+    qRegisterMetaType<FrameResult>("FrameResult");
+    setMessage("모델 로딩 중...");
+    startup.mark("ui", t);
 
-    // 2. DB 동적 생성
-    // db에 이름을 붙이는 이유는 읽기 전용, 쓰기 전용, 다른 db 등 여러 db에 접속할 수 있음을 고려(확장성 고려)
-    db = new DbManager("RecognizeConnection");
-    // 2.1 DB의 사용자 얼굴 이미지로 학습
-    if (trainFromDatabase()) {
-        setMessage("모델 준비 완료");
-    } else {
-        setMessage("모델 준비 실패(등록 데이터 부족 또는 DB 오류)");
-    }
+    // 2. 카메라 시작 (카메라 열기·재연결은 캡처 스레드에서 처리, 첫 프레임 표시까지 기록)
+    startCamera();
 
-    // 3. 시리얼 포트 연결 시도
-    if (!openSerial("/dev/rfcomm4", 9600)) {
-        if (!openSerial(QString(), 9600)) {
-            openSerial("/dev/ttyACM0", 9600);
+    // 3. 모델 준비 (DB 연결/캐시/적재/학습 → ModelStore에 게시)
+    modelLoader = new ModelLoader(&models, &startup, this);
+    connect(modelLoader, &ModelLoader::statusChanged, this, &MainWindow::setStatus, Qt::QueuedConnection);
+    connect(modelLoader, &ModelLoader::loaded, this, &MainWindow::onModelLoaded, Qt::QueuedConnection);
+    modelLoader->start();
+
+    // 4. 시리얼 (탐색/열기/재연결/쓰기/응답 읽기는 모두 시리얼 I/O 스레드, GUI는 상태만 받음)
+    serialProbeStartMs = startup.now();
+    serialLink = new SerialLink;
+    serialDiscovery = new SerialDiscovery(serialLink);
+    serialLink->moveToThread(&serialThread);
+    serialDiscovery->moveToThread(&serialThread);
+    connect(&serialThread, &QThread::finished, serialDiscovery, &QObject::deleteLater);
+    connect(&serialThread, &QThread::finished, serialLink, &QObject::deleteLater);
+    connect(serialDiscovery, &SerialDiscovery::stateChanged, this, &MainWindow::onSerialState, Qt::QueuedConnection);
+    connect(serialLink, &SerialLink::commandFinished, this,
+            [this](quint64 id, const QString& cmd, const QString& result, qint64 faceToDoneMs) {
+        // 최신 OPEN의 결과만 문 상태에 반영 (이전 OPEN의 늦은 시간 초과가 새 OPEN을 되돌리지 않도록)
+        if (cmd == "OPEN" && id == openCommandId) {
+            openCommandId = 0;
+            if (result == "done") {
+                doorDecision.openDone();
+            } else if (result == "pending") {
+                // 문이 이미 열려 있음(리드 LOW 대기) → 열림 유지, 닫히면 장치가 자동으로 잠금
+                qDebug().noquote() << "[Door] OPEN pending: door already open, keep open state";
+            } else if (doorDecision.isOpen()) {
+                // busy/lockout/시간 초과/포트 닫힘 → 닫힘으로 되돌리고 재시도 간격 뒤에 다시 OPEN
+                const int delay = doorDecision.openFailed(QDateTime::currentMSecsSinceEpoch());
+                qDebug().noquote() << "[Door] OPEN" << result << QString("→ retry in %1 ms").arg(delay);
+            }
         }
-    }
-
-    // 4. 카메라 시작
-    startCamera();
+        if (result == "done" && faceToDoneMs >= 0)
+            setStatus(QString("문 %1 완료 (얼굴 인식 → 동작 완료 %2 ms)").arg(cmd).arg(faceToDoneMs));
+        else if (result == "pending")
+            setStatus(QString("문 %1: 이미 열림 (닫힘 대기)").arg(cmd));
+        else if (result != "done" && result != "sent")
+            setStatus(QString("문 %1: %2").arg(cmd).arg(result));
+    }, Qt::QueuedConnection);
+    serialThread.start();
+    QMetaObject::invokeMethod(serialDiscovery, [d = serialDiscovery]() { d->start(); }, Qt::QueuedConnection);
 }
 
 MainWindow::~MainWindow() {
-    // 1. 카메라 종료
-    stopCamera();
-
-    // 2. 시리얼 닫기(MainWindow가 파괴되면서 닫히지만 명시적으로 닫아줌)
-    if (serial.isOpen()){
-        serial.close();
+    // 1. 모델 준비/갤러리 감시/시리얼 탐색/카메라 종료
+    if (modelLoader) {
+        delete modelLoader; // 진행 중이면 끝날 때까지 대기
+        modelLoader = nullptr;
     }
-
-    // 3. DB 동적 해제
-    if (db){
-        db->close();
-        delete db;
-        db = nullptr;
+    if (galleryWatcher) {
+        galleryWatcher->stop();
+        delete galleryWatcher;
+        galleryWatcher = nullptr;
     }
+    stopCamera();
+
+    // 2. 시리얼 닫기(I/O 스레드에서 닫고 응답 지연 요약 출력) → 스레드 종료 시 SerialLink 삭제
+    QMetaObject::invokeMethod(serialLink, [d = serialDiscovery, link = serialLink]() {
+        d->stop();
+        link->closePort();
+    }, Qt::BlockingQueuedConnection);
+    serialThread.quit();
+    serialThread.wait();
 
-    // 4. UI 제거
+    // 3. UI 제거
     delete ui;
 }
 
-// ---------- 변환/유틸 ----------
-// Mat -> QImage 변환
-QImage MainWindow::matToQImage(const cv::Mat& mat) {
-    if (mat.empty()) return QImage();
-    if (mat.type() == CV_8UC1) {
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_Grayscale8).copy();
-    } else if (mat.type() == CV_8UC3) {
-        cv::Mat rgb; cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        return QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
-    } else {
-        cv::Mat gray;
-        if (mat.channels() == 3) cv::cvtColor(mat, gray, cv::COLOR_BGR2GRAY);
-        else mat.convertTo(gray, CV_8U);
-        return QImage(gray.data, gray.cols, gray.rows, gray.step, QImage::Format_Grayscale8).copy();
-    }
+// ---------- 시작 단계 ----------
+// 모델 준비, 첫 프레임, 첫 시리얼 탐색이 모두 끝나면 단계별 시간 보고
+void MainWindow::finishStartupPhase() {
+    if (startupReported || modelState == ModelState::Loading || !firstFrameShown || !serialProbedOnce)
+        return;
+    startupReported = true;
+    startup.print();
 }
-// 프레임 이미지 + 텍스트 표시
-void MainWindow::showMatOn(QLabel* label, const cv::Mat& mat, const QString& text) {
-    if (!label) return;
 
-    QImage img = matToQImage(mat);
-    if (img.isNull()) return;
+void MainWindow::onModelLoaded(bool ok) {
+    modelState = ok ? ModelState::Ready : ModelState::Failed;
+    setMessage(ok ? "모델 준비 완료" : "모델 준비 실패(등록 데이터 부족 또는 DB 오류)");
 
-    if (!text.isEmpty()) {
+    // 갤러리 감시는 첫 모델 이후에 시작 (DB 실패 시에도 재연결 후 새 등록을 반영)
+    startGalleryWatcher();
+    finishStartupPhase();
+}
+
+// ---------- 화면 출력 ----------
+// 프레임 이미지 + 텍스트 → 화면용 이미지 (img 버퍼 재사용, FrameView.h)
+bool MainWindow::renderFrame(const cv::Mat& mat, const QString& text, const std::vector<FaceOverlay>& faces,
+                             QImage& img) {
+    if (!matToRgbImage(mat, img)) return false;
+
+    if (!text.isEmpty() || !faces.empty()) {
         QPainter painter(&img);
         painter.setRenderHint(QPainter::TextAntialiasing, true);
         painter.setPen(Qt::green);
-
-        // 폰트 : Noto → Nanum → 시스템 기본
-        QFont font;
-        QStringList candidates = {
-            "Noto Sans CJK KR", "Noto Sans KR", "NanumGothic", "Nanum Gothic"
-        };
-        bool set = false;
-        for (const QString& fam : candidates) {
-            if (QFontDatabase().families().contains(fam))
-            {
-                font.setFamily(fam);
-                set = true;
-                break;
-            }
-        }
-        if (!set) { // Fallback
-            // 시스템 기본 사용
-            font = painter.font();
-        }
-        font.setPointSize(14);
-        painter.setFont(font);
+        painter.setFont(overlayFont()); // Noto → Nanum → 시스템 기본 (한 번만 검색)
 
         // text 출력
-        painter.drawText(10, 25, text);
+        if (!text.isEmpty())
+            painter.drawText(10, 25, text);
+        // 얼굴별 결과는 박스 위(공간이 없으면 박스 안)에 출력: 등록=초록, 그 외=빨강
+        for (const FaceOverlay& f : faces) {
+            painter.setPen(f.ok ? Qt::green : Qt::red);
+            const int y = f.rect.y > 24 ? f.rect.y - 6 : f.rect.y + 20;
+            painter.drawText(f.rect.x, y, f.text);
+        }
         painter.end();
     }
-    // 이미지 출력
-    label->setPixmap(QPixmap::fromImage(img).scaled(label->size(),
-                                                    Qt::KeepAspectRatio, Qt::FastTransformation));
+    return true;
 }
-// 큰 사각형 찾기
-cv::Rect MainWindow::largestRect(const std::vector<cv::Rect>& rects) {
-    int idx = -1;
-    int areaMax = -1;
-    for (int i=0; i<(int)rects.size(); ++i) {
-        int a = rects[i].area();
-        if (a > areaMax)
-        {
-            areaMax = a;
-            idx = i;
+// 카메라 화면 출력: 1대면 그대로, 여러 대면 격자로 합성(칸마다 이름 + FPS/지연)
+void MainWindow::showCameras() {
+    QLabel* label = ui->videoLabel;
+    if (!label || cameras.empty()) return;
+
+    if (cameras.size() == 1) {
+        const QImage img = withStreamBadge(*cameras.front());
+        if (img.isNull()) return;
+        // 라벨 크기로 줄인 뒤 픽스맵 변환 (변환할 픽셀 수 감소)
+        label->setPixmap(QPixmap::fromImage(img.scaled(label->size(), Qt::KeepAspectRatio, Qt::FastTransformation)));
+        return;
+    }
+
+    const int n = (int)cameras.size();
+    const int cols = (int)std::ceil(std::sqrt((double)n));
+    const int rows = (n + cols - 1) / cols;
+    QImage canvas(label->size(), QImage::Format_RGB888);
+    canvas.fill(Qt::black);
+    QPainter painter(&canvas);
+    painter.setPen(Qt::yellow);
+    painter.setFont(overlayFont());
+    const int cellW = canvas.width() / cols;
+    const int cellH = canvas.height() / rows;
+    for (int i = 0; i < n; ++i) {
+        const CameraPipeline& cam = *cameras[i];
+        const QRect cell((i % cols) * cellW, (i / cols) * cellH, cellW, cellH);
+        if (!cam.lastImage.isNull()) {
+            const QImage scaled = withStreamBadge(cam).scaled(cell.size(), Qt::KeepAspectRatio, Qt::FastTransformation);
+            painter.drawImage(cell.x() + (cell.width() - scaled.width()) / 2,
+                              cell.y() + (cell.height() - scaled.height()) / 2, scaled);
         }
+        const QString door = (i == doorCamera) ? " [문]" : "";
+        painter.drawText(cell.adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignBottom,
+                         QString("%1%2  %3").arg(cam.name).arg(door).arg(cam.stats.overlay()));
     }
-    return (idx >= 0) ? rects[idx] : cv::Rect();
+    painter.end();
+    label->setPixmap(QPixmap::fromImage(canvas));
 }
-// HaarCascade 경로 찾기 및 확인
-QString MainWindow::findCascadeLocal() const {
-    QStringList candidates;
-    candidates << QDir(QCoreApplication::applicationDirPath()).filePath("haarcascade_frontalface_default.xml");
-    candidates << QDir::current().filePath("haarcascade_frontalface_default.xml");
-    candidates << "/usr/share/opencv4/haarcascades/haarcascade_frontalface_default.xml";
-
-    for (const auto& p : candidates)
-        if (QFile::exists(p))
-            return p;
-
-    return QString();
-}
-void MainWindow::ensureCascadeLoaded() {
-    if (!cascadePath.isEmpty() && !faceCasc.empty())
-        return;
-
-    cascadePath = findCascadeLocal();
-    if (!cascadePath.isEmpty())
-        faceCasc.load(cascadePath.toStdString());
+QImage MainWindow::withStreamBadge(const CameraPipeline& cam) {
+    if (!cam.streamDown || cam.lastImage.isNull())
+        return cam.lastImage;
+    QImage img = cam.lastImage.copy();
+    QPainter painter(&img);
+    painter.fillRect(QRect(0, 0, img.width(), 28), QColor(0, 0, 0, 160));
+    painter.setPen(Qt::red);
+    painter.drawText(QRect(8, 0, img.width() - 16, 28), Qt::AlignLeft | Qt::AlignVCenter,
+                     "연결 끊김 - 재연결 중 (마지막 화면)");
+    painter.end();
+    return img;
 }
 // 텍스트 메세지 출력
+// 같은 문자열이면 갱신하지 않음 (결과마다 호출되므로 레이아웃 재계산/다시 그리기 방지)
 void MainWindow::setStatus(const QString& s)  {
-    if (ui->lblStatus) ui->lblStatus->setText(s);
+    setTextIfChanged(ui->lblStatus, s);
 }
 void MainWindow::setMessage(const QString& s) {
-    if (ui->lblMessage) ui->lblMessage->setText(s);
-}
-
-// 원격 카메라용 설정값 읽기(환경변수 우선, 없으면 기본값)
-static QString envOr(const char* key, const QString& fallback = QString()) {
-    const QByteArray v = qgetenv(key);
-    return v.isEmpty() ? fallback : QString::fromUtf8(v);
+    setTextIfChanged(ui->lblMessage, s);
 }
 
 // ---------- 카메라 ----------
-// --- URL(원격) 우선, 실패 시 로컬로 폴백 ---
-bool MainWindow::openBestCamera() {
-    // 1) 원격(Qt 환경변수 설정)
-    QStringList urlCandidates;
-    const QString urls = envOr("STREAM_URLS");
-    if (!urls.isEmpty()) {
-        for (const auto& s : urls.split(';', Qt::SkipEmptyParts))
-            urlCandidates << s.trimmed();
-    }
-
-    // 이미 열려 있으면 닫기
-    if (cap.isOpened())
-        cap.release();
-
-    // 1.1) 원격 카메라 (FFmpeg → GStreamer 순서)
-    for (const QString& url : urlCandidates) {
-        if (cap.open(url.toStdString(), cv::CAP_FFMPEG)) {
-            setStatus(QString("원격 카메라(FFmpeg) 연결됨: %1").arg(url));
-            cap.set(cv::CAP_PROP_BUFFERSIZE, 1);
-            return true;
-        }
-        if (cap.open(url.toStdString(), cv::CAP_GSTREAMER)) {
-            setStatus(QString("원격 카메라(GStreamer) 연결됨: %1").arg(url));
-            cap.set(cv::CAP_PROP_BUFFERSIZE, 1);
-            return true;
-        }
-    }
-
-    // 2) 로컬 카메라
-    for (int idx : {0,1,2}) {
-        if (cap.open(idx)) {
-            setStatus(QString("로컬 카메라 연결됨 (index=%1)").arg(idx));
-            return true;
-        }
-    }
-    setStatus("카메라 열기 실패(원격/로컬 모두)");
-    return false;
-}
-// --- startCamera: URL 우선으로 시작하도록 교체 ---
+// 캡처/검출 스레드 시작 (카메라 열기·재연결은 캡처 스레드에서 처리)
+// MULTI_CAMERA=1: STREAM_URLS의 주소마다 캡처/검출 파이프라인 (모델은 ModelStore 하나를 공유, 읽기 전용)
+//                 문(시리얼) 판단은 DOOR_CAMERA(기본 0)번 카메라 결과로만
+// 그 외: STREAM_URLS는 후보 목록, 열리는 카메라 하나만 사용(기존 동작)
 void MainWindow::startCamera() {
-    if (!openBestCamera())
+    if (!cameras.empty())
         return;
-    ensureCascadeLoaded();
 
-    setStatus((cascadePath.isEmpty() || faceCasc.empty())
-                ? "카메라 시작됨 (얼굴 인식 불가능)"
-                : "카메라 시작됨 (얼굴 인식 가능)");
+    // 1. 카메라 목록
+    QStringList urls;
+    if (envIntOr("MULTI_CAMERA", 0) == 1) {
+        for (const auto& s : envOr("STREAM_URLS").split(';', Qt::SkipEmptyParts))
+            urls << s.trimmed();
+    }
+    const int count = std::max(1, (int)urls.size());
+    doorCamera = std::clamp(envIntOr("DOOR_CAMERA", 0), 0, count - 1);
+
+    // 2. 카메라마다 캡처 → 검출/인식 스레드 (카메라를 늘리면 스레드도 늘어 코어를 나눠 씀)
+    for (int i = 0; i < count; ++i) {
+        auto cam = std::make_unique<CameraPipeline>();
+        cam->name = QString("cam%1").arg(i);
+        cam->recognizeWorker = new RecognizeWorker(&cam->frameSlot, &cam->resultQueue,
+            [this](const std::vector<cv::Mat>& rois, std::vector<FacePrediction>& out) {
+                predictFaces(rois, out);
+            },
+            [this]() -> quint64 {
+                const std::shared_ptr<const ModelSnapshot> snap = models.current();
+                return snap ? snap->version : 0;
+            }, this);
+        cam->captureWorker = urls.isEmpty()
+            ? new CaptureWorker(&cam->frameSlot, this)
+            : new CaptureWorker(&cam->frameSlot, urls[i], cam->name, this);
+
+        connect(cam->recognizeWorker, &RecognizeWorker::resultReady, this, [this, i]() { onResultReady(i); },
+                Qt::QueuedConnection);
+        connect(cam->recognizeWorker, &RecognizeWorker::statusChanged, this, &MainWindow::setStatus, Qt::QueuedConnection);
+        connect(cam->captureWorker, &CaptureWorker::statusChanged, this, &MainWindow::setStatus, Qt::QueuedConnection);
+        // 끊김: 마지막 정상 화면을 그대로 두고 표시만 덧붙임 (재연결은 캡처 스레드가 백그라운드로)
+        connect(cam->captureWorker, &CaptureWorker::streamLost, this, [this, i]() {
+            cameras[i]->streamDown = true;
+            displayDirty = true;
+        }, Qt::QueuedConnection);
+        connect(cam->captureWorker, &CaptureWorker::streamRecovered, this, [this, i](qint64 outageMs, int attempts) {
+            cameras[i]->streamDown = false;
+            setStatus(QString("%1 카메라 복구: %2초 끊김, 재시도 %3회").arg(cameras[i]->name)
+                          .arg(outageMs / 1000.0, 0, 'f', 1).arg(attempts));
+            displayDirty = true;
+        }, Qt::QueuedConnection);
+
+        cam->recognizeWorker->start();
+        cam->captureWorker->start();
+        cameras.push_back(std::move(cam));
+    }
+    // 3. 화면 갱신 타이머 (인식 결과는 큐에서 바로 처리, 그리기는 이 주기로만)
+    connect(&displayTimer, &QTimer::timeout, this, &MainWindow::onDisplayTick, Qt::UniqueConnection);
+    displayTimer.start(displayIntervalMs());
 
-    connect(&timer, &QTimer::timeout, this, &MainWindow::onFrameTick, Qt::UniqueConnection);
-    timer.start(33);
+    if (count > 1)
+        qDebug().noquote() << QString("[Camera] multi-camera mode: %1 pipelines, door camera cam%2").arg(count).arg(doorCamera);
 }
 void MainWindow::stopCamera() {
-    timer.stop();
-    if (cap.isOpened())
-        cap.release();
-    setStatus("카메라 중지됨");
-}
-
-// ---------- DB → 학습 ----------
-bool MainWindow::trainFromDatabase() {
-    // 1. 초기화
-    labelToName.clear();
-    pairToLabel.clear();
-    conflictIds.clear();
-    nextLabelId = 1;
-#if HAS_OPENCV_FACE
-    model = cv::face::LBPHFaceRecognizer::create(1, 8, 8, 8, threshold);
-    model->setThreshold(threshold);
-#endif
-
-    // 2. DB 연결
-    if (!db->open()) {
-        setStatus("DB 연결 실패");
-        return false;
-    }
-
-    // 3. ID - 이름 충돌 스캔(SELECT)
-    {
-        QHash<int, QSet<QString>> namesPerId;
-        QSqlQuery q(db->database());
-        if (!q.exec("SELECT user_id, user_name FROM face_images")) {
-            setStatus(QString("DB 조회 실패: %1").arg(q.lastError().text()));
-            return false;
-        }
-        while (q.next()) {
-            int uid = q.value(0).toInt();
-            QString uname = q.value(1).toString().trimmed();
-            namesPerId[uid].insert(uname);
+    displayTimer.stop();
+    // 카메라마다 생산자(캡처) → 소비자(검출) 순서로 정지
+    for (auto& cam : cameras) {
+        if (cam->captureWorker) {
+            cam->captureWorker->stop();
+            delete cam->captureWorker;
+            cam->captureWorker = nullptr;
         }
-        for (auto it = namesPerId.begin(); it != namesPerId.end(); ++it) {
-            if (it.value().size() > 1) {
-                conflictIds.insert(it.key());
-                qWarning() << "[WARN] user_id" << it.key()
-                           << "has multiple names:" << it.value().values();
-            }
+        if (cam->recognizeWorker) {
+            cam->recognizeWorker->stop();
+            delete cam->recognizeWorker;
+            cam->recognizeWorker = nullptr;
         }
+        cam->resultQueue.close();
     }
+    cameras.clear();
+    setStatus("카메라 중지됨");
+}
 
-    // 4. 실제 이미지 적재 / 라벨링(SELECT)
-    std::vector<cv::Mat> images; // gray 128x128
-    std::vector<int> labels;
-    int loaded = 0;
+// ---------- 갤러리 감시 ----------
+void MainWindow::startGalleryWatcher() {
+    if (galleryWatcher || envIntOr("GALLERY_POLL_MS", 3000) <= 0)
+        return;
+    galleryWatcher = new GalleryWatcher(&models, this);
+    connect(galleryWatcher, &GalleryWatcher::statusChanged, this, &MainWindow::setStatus, Qt::QueuedConnection);
+    galleryWatcher->start(QThread::LowPriority);
+}
 
-    QSqlQuery q2(db->database());
-    if (!q2.exec("SELECT user_id, user_name, face_data FROM face_images ORDER BY created_at ASC")) {
-        setStatus(QString("DB 조회 실패: %1").arg(q2.lastError().text()));
-        return false;
+// ---------- 예측 ----------
+void MainWindow::predictFaces(const std::vector<cv::Mat>& roisGray128, std::vector<FacePrediction>& out) {
+    // 점수는 낮을수록 유사. score <= threshold일 때 매칭 성공으로 본다(handleResult).
+    // 스냅샷을 잡은 동안에는 감시 스레드가 모델을 교체해도 안전 (배치 전체가 같은 모델 사용)
+    const std::shared_ptr<const ModelSnapshot> snap = models.current();
+    if (!snap || !snap->recognizer || snap->recognizer->empty()) {
+        out.assign(roisGray128.size(), FacePrediction());
+        return;
     }
-    while (q2.next()) {
-        int uid = q2.value(0).toInt();
-        QString uname = q2.value(1).toString().trimmed();
-        QByteArray ba = q2.value(2).toByteArray();
-
-        // 이미지 변환
-        cv::Mat gray128;
-        if (!decodeRowToGray128(ba, gray128)) continue;
-
-        // 헬퍼 함수 2
-        int labelInt = -1;
-        if (conflictIds.contains(uid)) {
-            // 충돌: user_id는 (uid, uname) 단위로 분리
-            labelInt = ensureLabelForPair(uid, uname);
-        } else {
-            // 충돌 없음: user_id 하나당 단일 이름으로 간주
-            // 같은 user_id의 모든 샘플은 같은 labelInt 사용
-            labelInt = ensureLabelForPair(uid, uname.isEmpty() ? QString::number(uid) : uname);
-        }
+    snap->recognizer->predictBatch(roisGray128, out);
+}
 
-        images.push_back(gray128);
-        labels.push_back(labelInt);
-        loaded++;
-    }
-    if (loaded == 0) {
-        setStatus("DB에 등록 데이터가 없습니다");
-        return false;
+// ---------- 결과 처리(GUI 스레드) ----------
+// 검출/인식 스레드 알림 → 그 카메라의 결과 큐 비우기. 시리얼 판단은 결과마다, 화면은 마지막 1장만 그림
+void MainWindow::onResultReady(int index) {
+    if (index < 0 || index >= (int)cameras.size())
+        return;
+    CameraPipeline& cam = *cameras[index];
+    if (!cam.recognizeWorker)
+        return;
+    cam.recognizeWorker->clearNotify();
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    FrameResult res;
+    FrameResult last;
+    bool any = false;
+    while (cam.resultQueue.pop(res)) {
+        handleResult(res, cam, index == doorCamera);
+        cam.stats.add(res, now);
+        last = std::move(res);
+        any = true;
     }
+    if (!any)
+        return;
+    const QString summary = cam.stats.takeSummary(cam.name, cam.frameSlot.droppedCount(), now);
+    if (!summary.isEmpty())
+        qDebug().noquote() << summary;
 
-    // 5. 학습 : ON / OFF 분기
-#if HAS_OPENCV_FACE
-    try {
-        model->train(images, labels);
-        setStatus(QString("학습 완료: %1장, 클래스 %2개")
-                      .arg(loaded)
-                      .arg(QSet<int>(labels.begin(), labels.end()).size()));
-    } catch (const cv::Exception& e) {
-        setStatus(QString("LBPH 학습 오류: %1").arg(e.what()));
-        return false;
-    }
-#else
-    trainImages = images;
-    trainLabels = labels;
-    setStatus(QString("학습(단순 NN) 준비: %1장, 클래스 %2개")
-                  .arg(loaded)
-                  .arg(QSet<int>(labels.begin(), labels.end()).size()));
-#endif
-    return true;
+    // 그리기는 다음 화면 갱신 때 (그 사이 결과가 더 오면 마지막 것만 그림)
+    cam.lastFrame = last.frame;
+    cam.frameDirty = true;
 }
 
-bool MainWindow::decodeRowToGray128(const QByteArray& png, cv::Mat& outGray128, cv::Mat* outColor128) {
-    std::vector<uchar> buf(png.begin(), png.end());
-
-    cv::Mat img = cv::imdecode(buf, cv::IMREAD_COLOR); // DB 이미지(컬러)를 Mat으로 복원
-    if (img.empty())
-        return false;
-
-    cv::Mat gray; cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY); // 컬러를 흑백으로 변경
-    cv::resize(gray, outGray128, cv::Size(128,128)); // 사이즈 표준화(128x128)
-
-    if (outColor128) {
-        cv::Mat color128;
-        cv::resize(img, color128, cv::Size(128,128));
-        *outColor128 = color128;
+// 화면 갱신: 새 결과가 있는 카메라만 그림, 그리기 시간은 카메라별 통계(render)에 포함
+void MainWindow::onDisplayTick() {
+    bool changed = displayDirty;
+    for (auto& cam : cameras) {
+        if (!cam->frameDirty)
+            continue;
+        QElapsedTimer clock;
+        clock.start();
+        // videoLabel에 표시되는 프레임 위 오버레이(이름/신뢰도 또는 거리)
+        renderFrame(cam->lastFrame, cam->lastOverlay, cam->lastFaceOverlays, cam->lastImage);
+        cam->lastFrame.release();
+        cam->frameDirty = false;
+        cam->stats.addRender(clock.nsecsElapsed() / 1e6);
+        changed = true;
     }
-
-    return true;
-}
-int MainWindow::ensureLabelForPair(int uid, const QString& uname) {
-    QPair<int, QString> key(uid, uname);
-    if (!pairToLabel.contains(key)) {
-        int label = nextLabelId++;
-        pairToLabel.insert(key, label);
-        labelToName.insert(label, uname);
+    if (!changed)
+        return;
+    displayDirty = false;
+
+    QElapsedTimer clock;
+    clock.start();
+    showCameras();
+    const double showMs = clock.nsecsElapsed() / 1e6;
+    for (auto& cam : cameras)
+        cam->stats.addDisplay(showMs);
+
+    if (!firstFrameShown && !cameras.front()->lastImage.isNull()) {
+        firstFrameShown = true;
+        startup.mark("camera.first-frame", 0);
+        finishStartupPhase();
     }
-    return pairToLabel.value(key);
 }
 
-// ---------- 예측 ----------
-bool MainWindow::predictLabel(const cv::Mat& roiGray128, int& outLabel, double& outScore) {
-#if HAS_OPENCV_FACE
-    int label = -1;
-    double conf = 0.0;
-    model->predict(roiGray128, label, conf);
-    outLabel = label;
-    outScore = conf;
-    // LBPH는 낮을수록 유사. conf <= threshold일 때 매칭 성공으로 본다.
+// door=false인 카메라(다중 카메라 모드의 감시용)는 오버레이만 갱신, 메시지/시리얼은 문 카메라만
+void MainWindow::handleResult(const FrameResult& res, CameraPipeline& cam, bool door) {
+    auto message = [&](const QString& s) { if (door) setMessage(s); };
+    std::vector<DoorObservation> doorFaces; // 문 판단 입력 (트랙별 수락 여부)
+
+    QString overlayText;               // 화면 상단 요약 문자열
+    std::vector<FaceOverlay> overlays; // 얼굴마다 박스 위에 덮어쓸 문자열(이름 + 신뢰도/거리)
+
+    // 예측: 얼굴마다 ROI 128x128 그레이 배치로 모델에 입력(검출 스레드에서 수행)
+    // 문 판단: 등록된 얼굴이 하나라도 있으면 열림 (함께 들어오는 미등록 얼굴 때문에 흔들리지 않음)
+    if (!res.faces.empty()) {
+        const std::shared_ptr<const ModelSnapshot> snap = models.current();
+        if (!snap && modelState == ModelState::Loading) {
+            // 모델 준비 전: 미리보기는 그대로, 문은 열지 않음
+            overlayText = "모델 로딩 중...";
+            message(overlayText);
+        } else if (!snap) {
+            message("예측 실패");
+            overlayText = "예측 실패";
+        } else {
+            // 낮을수록 유사 (LBPH 신뢰도 / NN 거리)
+            // 라벨 번호는 갤러리 갱신 후에도 유지되므로 최신 스냅샷으로 이름 조회
+            const FaceRecognizer& recognizer = *snap->recognizer;
+            const QString kind = recognizer.name();
+            QStringList known;
+            for (const FaceResult& f : res.faces) {
+                const bool ok = f.predicted && recognizer.accepts(f.score) && f.label != -1;
+                doorFaces.push_back(DoorObservation{f.trackId, f.label, ok});
+                QString text;
+                if (!f.predicted) {
+                    text = "예측 실패";
+                } else if (ok) {
+                    const QString who = snap->gallery->labelToName.value(f.label, "알 수 없음");
+                    known << QString("%1 (라벨=%2, %3=%4)").arg(who).arg(f.label)
+                                 .arg(recognizer.scoreName()).arg(QString::number(f.score, 'f', 1));
+                    text = QString("%1  (%2 %3)").arg(who)
+                               .arg(recognizer.scoreName()).arg(QString::number(f.score, 'f', 1));
+                } else {
+                    text = "미등록";
+                }
+                overlays.push_back(FaceOverlay{f.rect, text, ok});
+            }
 
-    return true;
-#else
-    // 간단 최근접 이웃 (L2 거리). 낮을수록 유사.
-    if (trainImages.empty())
-        return false;
-    double best = 1e18;
-    int bestLabel = -1;
-
-    for (size_t i=0; i<trainImages.size(); ++i) {
-        cv::Mat diff;
-        cv::absdiff(roiGray128, trainImages[i], diff);
-        diff.convertTo(diff, CV_32F);
-        double dist = std::sqrt(cv::sum(diff.mul(diff))[0]);
-        if (dist < best)
-        {
-            best = dist;
-            bestLabel = trainLabels[i];
+            const bool anyOk = !known.isEmpty();
+            if (anyOk)
+                message(QString("인식(%1): %2").arg(kind).arg(known.join(", ")));
+            else
+                message(QString("인식(%1) 실패: 미등록").arg(kind));
+            if (res.faces.size() > 1)
+                overlayText = QString("얼굴 %1개, 인식 %2명 [%3 ms]")
+                                  .arg(res.faces.size()).arg(known.size()).arg(res.predictMs, 0, 'f', 1);
         }
+    } else {
+        overlayText = "얼굴을 화면 중앙에 맞춰주세요";
+        message(overlayText);
     }
-    outLabel = bestLabel;
-    outScore = best;
-    return true;
-#endif
-}
-
-// ---------- 프레임 루프 ----------
-void MainWindow::onFrameTick() {
-    static int emptyCount = 0;
-
-    cv::Mat frame;
-    cap >> frame;
+    cam.lastOverlay = overlayText;
+    cam.lastFaceOverlays = std::move(overlays);
 
-    // 프레임 손실 복구
-    if (frame.empty()) {
-        if (++emptyCount >= 15) { // 약 0.5초(33ms*15) 동안 프레임 없으면 재연결
-            emptyCount = 0;
-            setStatus("카메라 프레임 끊김 → 재연결 시도");
-            cap.release();
-            openBestCamera(); // 원격 우선, 실패 시 로컬 재시도
-        }
+    // 문 판단: 얼굴이 없거나 모델이 없는 프레임도 시간 경과로 반영 (CLOSE 대기)
+    if (!door)
         return;
-    }
-    emptyCount = 0;
-
-    // 얼굴 인식 준비
-    QString overlayText;  // 화면에 덮어쓸 문자열(이름 + 신뢰도/거리)
-    ensureCascadeLoaded();
-    cv::Rect best;
-    // 얼굴 검출
-    if (!cascadePath.isEmpty() && !faceCasc.empty()) {
-        cv::Mat gray;
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::equalizeHist(gray, gray);
-        std::vector<cv::Rect> faces;
-        faceCasc.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(60,60));
-        best = largestRect(faces);
-        for (const auto& r : faces)
-            cv::rectangle(frame, r, cv::Scalar(0,255,0), 2);
-    }
-    // 예측: 얼굴 있으면 ROI 128x128 그레이로 변환하여 모델에 입력
-    if (best.area() > 0) {
-        cv::Mat roi = frame(best).clone();
-        cv::Mat gray;
-        cv::cvtColor(roi, gray, cv::COLOR_BGR2GRAY);
-        cv::resize(gray, gray, cv::Size(128,128));
-
-        int label = -1;
-        double score = 0.0;
-        if (predictLabel(gray, label, score)) {
-#if HAS_OPENCV_FACE
-            // LBPH: 낮을수록 유사
-            bool ok = (score <= threshold);
-            if (ok) {
-                QString who = labelToName.value(label, "알 수 없음");
-                setMessage(QString("인식(LBPH): %1 (라벨=%2, 신뢰도=%3)")
-                               .arg(who).arg(label).arg(QString::number(score, 'f', 1)));
-                overlayText = QString("%1  (신뢰도 %2)").arg(who).arg(QString::number(score, 'f', 1));
-            } else {
-                setMessage("인식(LBPH) 실패: 미등록");
-                overlayText = "미등록";
-            }
-#else
-            // Fallback NN: L2 거리, 낮을수록 유사
-            bool ok = (score <= threshold);
-            if (ok && label != -1) {
-                QString who = labelToName.value(label, "알 수 없음");
-                setMessage(QString("인식(NN): %1 (라벨=%2, 거리=%3)")
-                               .arg(who).arg(label).arg(QString::number(score, 'f', 1)));
-                overlayText = QString("%1  (거리 %2)").arg(who).arg(QString::number(score, 'f', 1));
-            } else {
-                setMessage("인식(NN) 실패: 미등록");
-                overlayText = "미등록";
-            }
-#endif      // 아두이노 OPEN 전송
-            sendSerial(ok);
-        } else {
-            setMessage("예측 실패");
-            overlayText = "예측 실패";
-            // 아두이노 CLOSE 전송
-            sendSerial(false);
-        }
-    } else {
-        overlayText = "얼굴을 화면 중앙에 맞춰주세요";
-        setMessage(overlayText);
-        // 아두이노 CLOSE 전송
+    const DoorCommand cmd = doorDecision.update(res.tsMs, doorFaces);
+    if (cmd == DoorCommand::Open) {
+        qDebug().noquote() << "[Door] OPEN:" << doorDecision.lastReason();
+        sendSerial(true, doorDecision.openFaceMs());
+    } else if (cmd == DoorCommand::Close) {
         sendSerial(false);
     }
-    // videoLabel에 표시되는 프레임 위 오버레이(이름/신뢰도 또는 거리)
-    showMatOn(ui->videoLabel, frame, overlayText);
 }
 
-// 블루투스(rfcomm) 우선 포트 자동 탐색
-static QString pickBtPort() {
-#ifdef Q_OS_LINUX
-    // 1. 고정 바인딩(rfcomm4)
-    if (QFile::exists("/dev/rfcomm4"))
-        return "/dev/rfcomm4";
-#endif
-    // 2. rfcomm 계열/블루투스
-    const auto ports = QSerialPortInfo::availablePorts();
-    for (const auto& info : ports) {
-        const QString name = info.systemLocation();   // /dev/rfcomm1, /dev/ttyACM0 등
-        const QString desc = info.description();      // "Bluetooth Device", "HC-06" 등
-        const QString manf = info.manufacturer();     // "Silicon Labs", "Bluetooth" 등
-        if (name.contains("rfcomm")
-            || desc.contains("HC-06", Qt::CaseInsensitive)
-            || desc.contains("BT04", Qt::CaseInsensitive)
-            || manf.contains("Bluetooth", Qt::CaseInsensitive))
-        {
-            return name;
-        }
-    }
-    // 3. 유선 USB(아두이노)
-    for (const auto& info : ports) {
-        const QString name = info.systemLocation();
-        if (name.contains("ttyACM") || name.contains("ttyUSB"))
-            return name;
-    }
-    return {};
-}
-// ----- 시리얼 열기 -----
-bool MainWindow::openSerial(const QString& portName, int baud) {
-    // 1. OPEN 확인(열려있는 경우 true -> 연결 유지)
-    if (serial.isOpen())
-        return true;
-
-    // 2. 아닌 경우 portName 저장
-    QString port = portName;
-
-    // 3. portName이 ""(=없음)인 경우 포트선택
-    // 헬퍼함수 1 / pickBtPort()
-#ifdef Q_OS_LINUX
-    if (port.isEmpty() || (port.startsWith("/dev/") && !QFile::exists(port)))
-        port = pickBtPort();
-#else
-    if (port.isEmpty())
-        port = pickBtPort();
-#endif
-
-    if (port.isEmpty())
-    {
-        setStatus("사용 가능한 시리얼 포트를 찾지 못했습니다. (/dev/rfcomm4 바인딩 확인)");
-        return false;
+// ----- 시리얼 상태 (SerialDiscovery → GUI) -----
+void MainWindow::onSerialState(SerialState state, const QString& port, const QString& detail) {
+    serialConnected = (state == SerialState::Connected);
+    switch (state) {
+    case SerialState::Connected:
+        setStatus(QString("시리얼 연결됨: %1").arg(port));
+        break;
+    case SerialState::Waiting:
+        setStatus(QString("시리얼 대기: %1").arg(detail));
+        break;
+    default:
+        return; // 탐색/열기 중 표시는 생략 (짧게 지나감)
     }
 
-    // 4. 시리얼 파라미터 설정
-    serial.setPortName(port);
-    serial.setBaudRate(baud);                 // HC-06 기본 9600(통신속도)
-    serial.setDataBits(QSerialPort::Data8);
-    serial.setParity(QSerialPort::NoParity);
-    serial.setStopBits(QSerialPort::OneStop);
-    serial.setFlowControl(QSerialPort::NoFlowControl);
-
-    // 5. 시리얼 열기
-    if (!serial.open(QIODevice::ReadWrite)) {
-        setStatus(QString("시리얼 열기 실패: %1 (%2)").arg(port).arg(serial.errorString()));
-        return false;
+    // 첫 탐색 + 열기 결과가 나온 시각을 시작 단계로 기록
+    if (!serialProbedOnce) {
+        serialProbedOnce = true;
+        startup.mark("serial.probe+open", serialProbeStartMs);
+        finishStartupPhase();
     }
-
-    // 5.1 에러 발생 시 자동 재연결(0.5초 후 재시도)
-    connect(&serial, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError e)
-            {
-                if (e == QSerialPort::ResourceError || e == QSerialPort::PermissionError) {
-                    serial.close();
-                    QTimer::singleShot(500, [this]() {
-                        // 마지막 설정 유지해 재시도 (포트 자동 선택)
-                        openSerial(QString(), serial.baudRate());
-                    });
-                }
-            });
-
-    // 6. 성공 메시지 설정
-    setStatus(QString("시리얼 연결됨: %1 @ %2bps").arg(port).arg(baud));
-    return true;
 }
 
 // ----- 제어 신호 보내기 -----
-void MainWindow::sendSerial(bool on) {
-    if (!serial.isOpen()) {
-        if (!openSerial(QString(), 9600))
-            return;
-    }
-
-    // 튜닝 파라미터
-    static const int OPEN_CONFIRM_FRAMES = 5;     // 연속 ok 프레임 수(≈ 5*33ms ≈ 165ms ≈ 0.165초)
-    static const int CLOSE_GRACE_MS      = 3000;  // ok 끊긴 뒤 닫기까지 대기 시간(3초)
-
-    // 내부 상태
-    // 현재 문이 "열림 상태"라고 판단했는지?
-    static int    okStreak = 0;           // 연속 ok 카운트
-    static qint64 lastSeenOkMs = 0;       // 마지막으로 ok 본 시각(ms)
-    const qint64 now = QDateTime::currentMSecsSinceEpoch(); // 현재시간
-
-    // 연속 ok 카운트/타임스탬프 갱신
-    if (on) {
-        okStreak++;
-        lastSeenOkMs = now;
-    } else {
-        okStreak = 0;
-    }
-
-    // 1) 아직 안 열린 상태에서, ok가 충분히 안정되면 한 번만 OPEN 전송
-    if (!isOpen && okStreak >= OPEN_CONFIRM_FRAMES) {
-        serial.write("OPEN\n");
-        serial.flush();
-        serial.waitForBytesWritten(10);
-        isOpen = true;
-        // OPEN 직후에는 바로 CLOSE가 나가지 않도록 lastSeenOkMs가 now로 찍혀 있음
+// 명령 전송 (열기/닫기 판단은 DoorDecision). 큐에 넣고 바로 반환 — 쓰기/응답 대기는 I/O 스레드
+// 포트가 열려 있을 때만 문 상태 갱신 → 못 보냈으면 다음 결과에서 다시 (재연결은 SerialDiscovery가 알아서)
+void MainWindow::sendSerial(bool on, qint64 faceSeenMs) {
+    if (!serialConnected)
         return;
-    }
 
-    // 2) 열린 상태에서, ok가 일정 시간(CLOSE_GRACE_MS) 동안 안 보이면 한 번만 CLOSE 전송
-    if (isOpen && (now - lastSeenOkMs) > CLOSE_GRACE_MS) {
-        serial.write("CLOSE\n");
-        serial.flush();
-        serial.waitForBytesWritten(10);
-        isOpen = false;
-        return;
-    }
+    const QByteArray cmd = on ? "OPEN" : "CLOSE";
+    const quint64 id = ++nextCommandId;
+    openCommandId = on ? id : 0;
+    QMetaObject::invokeMethod(serialLink, [link = serialLink, cmd, faceSeenMs, id]() { link->send(cmd, faceSeenMs, id); },
+                              Qt::QueuedConnection);
+    doorDecision.setOpen(on); // 응답 전까지는 열림으로 간주 (중복 전송 방지), 실패하면 commandFinished에서 되돌림
 }
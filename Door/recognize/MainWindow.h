@@ -2,32 +2,58 @@
 #include <QMainWindow>
 #include <QTimer>
 #include <QLabel>
+#include <QImage>
 #include <QString>
 #include <QElapsedTimer>
+#include <QThread>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 #include <QHash>
-#include <QSerialPort>
-#include <QSerialPortInfo>
-#include <QFile>
 #include <QSet>
 #include <QPair>
 #include <opencv2/opencv.hpp>
-#include "DbManager.h"
+#include "BoundedQueue.h"
+#include "FrameTypes.h"
+#include "LatestFrameSlot.h"
+#include "FaceRecognizer.h"
+#include "Gallery.h"
+#include "ModelStore.h"
+#include "StartupReport.h"
+#include "CameraStats.h"
+#include "DoorDecision.h"
+#include "SerialDiscovery.h"
+#include <memory>
+#include <vector>
 
+// 얼굴 하나의 화면 오버레이
+struct FaceOverlay {
+    cv::Rect rect;
+    QString text;
+    bool ok = false; // 등록된 얼굴로 인식
+};
 
-#if __has_include(<opencv2/face.hpp>)
-#include <opencv2/face.hpp>
-#define HAS_OPENCV_FACE 1
-#else
-#define HAS_OPENCV_FACE 0
-#endif
+class CaptureWorker;
+class RecognizeWorker;
 
+// 카메라 하나의 파이프라인: 캡처 스레드 → (frameSlot, 최신 1장) → 검출/인식 스레드 → (resultQueue) → GUI
+struct CameraPipeline {
+    QString name;
+    LatestFrameSlot frameSlot;
+    BoundedQueue<FrameResult> resultQueue{2, DropPolicy::DropOldest};
+    CaptureWorker* captureWorker = nullptr;
+    RecognizeWorker* recognizeWorker = nullptr;
+    QString lastOverlay;                       // 마지막 결과의 오버레이 문자열
+    std::vector<FaceOverlay> lastFaceOverlays; // 마지막 결과의 얼굴별 오버레이
+    cv::Mat lastFrame;                         // 아직 그리지 않은 마지막 결과 프레임
+    bool frameDirty = false;                   // 마지막 화면 이후 새 결과 있음
+    QImage lastImage;                          // 오버레이까지 그린 마지막 화면 (버퍼 재사용)
+    CameraStats stats;                         // 카메라별 FPS/지연
+    bool streamDown = false;                   // 재연결 중 (마지막 정상 화면 위에 표시)
+};
 
-// QPair<int, QString>형 key
-inline uint qHash(const QPair<int, QString>& key, uint seed = 0) {
-    return qHash(key.first, seed) ^ qHash(key.second, seed * 1315423911u);
-}
+class GalleryWatcher;
+class ModelLoader;
+class SerialLink;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -40,58 +66,62 @@ public:
     ~MainWindow();
 
 private slots:
-    void onFrameTick();
+    void onResultReady(int camera); // 검출/인식 결과 도착(Queued) → 표시 + 아두이노 제어
+    void onModelLoaded(bool ok); // 시작 시 모델 준비 완료(Queued)
+    void onDisplayTick();        // 화면 갱신 (DISPLAY_FPS, 인식 결과와 분리)
 
 private:
     Ui::MainWindow *ui;
 
-    DbManager* db = nullptr; // DB
-    QTimer timer; // Timer(Sig: timeout -> Slot: onFrameTick)
-    cv::VideoCapture cap; // 카메라
-    QSerialPort serial; // 아두이노 시리얼 포트
+    // 아두이노 시리얼: SerialDiscovery(탐색/재연결) + SerialLink(포트 + 명령 큐 + 응답 파싱)는 serialThread에서 동작
+    QThread serialThread;
+    SerialLink* serialLink = nullptr;           // serialThread 소유 (종료 시 deleteLater)
+    SerialDiscovery* serialDiscovery = nullptr; // 〃
+    bool serialConnected = false;   // 포트 열림 (SerialDiscovery 상태로 갱신, 프레임 루프는 이것만 봄)
+    quint64 nextCommandId = 0;      // 보낸 명령 번호 (SerialLink::commandFinished와 짝지음)
+    quint64 openCommandId = 0;      // 결과를 기다리는 최신 OPEN (0=없음, 그 뒤 CLOSE를 보냈으면 0)
+    qint64 serialProbeStartMs = 0;  // 첫 탐색 시작 (시작 단계 기록용)
+
+    // 시작 단계: 각 단계는 동시에 진행, 모두 끝나면 단계별 시간 보고
+    enum class ModelState { Loading, Ready, Failed };
+    StartupReport startup;
+    ModelState modelState = ModelState::Loading;
+    bool firstFrameShown = false;
+    bool serialProbedOnce = false;
+    bool startupReported = false;
 
-    // 얼굴 검출
-    cv::CascadeClassifier faceCasc;
-    QString cascadePath;
+    // 카메라 파이프라인 (MULTI_CAMERA=1이면 STREAM_URLS 주소마다 하나)
+    std::vector<std::unique_ptr<CameraPipeline>> cameras;
+    int doorCamera = 0; // 문(시리얼) 판단에 쓰는 카메라, DOOR_CAMERA
+    QTimer displayTimer;       // 화면 갱신 주기 (결과가 더 자주 와도 이 주기로만 그림)
+    bool displayDirty = false; // 끊김 표시 등 프레임 외 변경
 
-    QHash<int, QString> labelToName; // 예측라벨(int) -> 표시이름(String)
-    QHash<QPair<int, QString>, int> pairToLabel; // user_id, user_name -> 내부 정수 라벨
-    int nextLabelId = 1; // 충돌 : 특정 user_id에 복수 이름이 있으면 true
-    QSet<int> conflictIds; // 충돌된 ID
+    // 인식 모델(인식기 + 갤러리 스냅샷). 검출 스레드/GUI는 current()로 읽고, 갱신은 통째로 교체
+    ModelStore models;
+    ModelLoader* modelLoader = nullptr;       // 시작 시 DB/캐시 → 학습 (백그라운드)
+    GalleryWatcher* galleryWatcher = nullptr; // 새 등록/삭제 감시 → 증분 갱신
 
-    // 아두이노 도어락 문 열림 상태
-    bool isOpen = false;
+    // 아두이노 도어락 열기/닫기 판단 (트랙별 시간 투표, 문 열림 상태 포함)
+    DoorDecision doorDecision;
 
 
-#if HAS_OPENCV_FACE
-    // LBPH
-    cv::Ptr<cv::face::LBPHFaceRecognizer> model; // LBPH 모델
-    double threshold = 75.0;   // LBPH 한계점(신뢰도) : 낮을수록 더 유사. 환경에 맞춰 조정.
-#else
-    // Fallback: 간단 최근접 이웃 (L2) — 품질은 낮지만 의존성 없이 동작
-    std::vector<cv::Mat> trainImages;  // gray 128x128, CV_8U
-    std::vector<int>     trainLabels;
-    double threshold = 3000.0; // NN 한계점(거리) : L2 거리 임계값(환경에 맞춰 조정)
-#endif
+    // 얼굴 인식기는 FACE_RECOGNIZER=lbph|nn|lbph-compact|lbph-contrib 실행 시 선택, SHADOW_RECOGNIZER로 후보 비교
     // 카메라
-    bool openBestCamera();
     void startCamera();
     void stopCamera();
     // 상태표시
     void setStatus(const QString& s);
     void setMessage(const QString& s);
-    void showMatOn(QLabel* label, const cv::Mat& mat, const QString& text = QString());
-    static QImage matToQImage(const cv::Mat& mat);
-    // HaarCascade
-    static cv::Rect largestRect(const std::vector<cv::Rect>& rects);    
-    void ensureCascadeLoaded();
-    QString findCascadeLocal() const;
-    // LBPH 학습/예측
-    bool trainFromDatabase();                 // DB → 이미지/라벨 로드 → 학습
-    int ensureLabelForPair(int uid, const QString& uname); // uid, uname 를 정수 라벨로 매핑
-    bool decodeRowToGray128(const QByteArray& png, cv::Mat& outGray128, cv::Mat* outColor128=nullptr);
-    bool predictLabel(const cv::Mat& roiGray128, int& outLabel, double& outScore);
+    static bool renderFrame(const cv::Mat& mat, const QString& text, const std::vector<FaceOverlay>& faces,
+                            QImage& img); // img 버퍼에 프레임 + 오버레이
+    void showCameras(); // 카메라 화면(1대 그대로 / 여러 대 격자)
+    static QImage withStreamBadge(const CameraPipeline& cam); // 끊김이면 마지막 화면 + "재연결 중" 표시
+    void handleResult(const FrameResult& res, CameraPipeline& cam, bool door); // 결과 1건: 얼굴별 오버레이, (문 카메라) 메시지/시리얼
+    void finishStartupPhase(); // 모든 시작 단계가 끝났으면 시간 보고(1회)
+    // 예측 (학습은 ModelLoader/GalleryWatcher가 수행)
+    void startGalleryWatcher();
+    void predictFaces(const std::vector<cv::Mat>& roisGray128, std::vector<FacePrediction>& out);
     // 아두이노 통신
-    bool openSerial(const QString& portName = QString("/dev/ttyACM0"), int baud = 9600);
-    void sendSerial(bool on);   // true=LED ON, false=LED OFF
+    void onSerialState(SerialState state, const QString& port, const QString& detail); // 연결 상태(Queued)
+    void sendSerial(bool on, qint64 faceSeenMs = 0); // true=OPEN, false=CLOSE (doorDecision이 결정한 명령만)
 };
@@ -0,0 +1,125 @@
+#include "ModelLoader.h"
+#include "DbManager.h"
+#include "GalleryCache.h"
+#include "GalleryLoader.h"
+#include "StartupReport.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+
+ModelLoader::ModelLoader(ModelStore* store, StartupReport* report, QObject* parent)
+    : QThread(parent), store(store), report(report) {}
+
+ModelLoader::~ModelLoader() {
+    // DB 조회/학습 중에는 끊을 수 없으므로 끝날 때까지 대기
+    requestInterruption();
+    wait();
+}
+
+void ModelLoader::run() {
+    // 연결 이름은 기존과 같게 유지 (이 스레드에서 만들고 이 스레드에서 닫음)
+    DbManager db("RecognizeConnection");
+    const bool ok = trainFromDatabase(db);
+    db.close();
+    emit loaded(ok);
+}
+
+// 시작 시간 단축: DB 지문(행 수 + 최신 created_at)이 캐시와 같으면 전처리된 템플릿으로 바로 학습
+// DB에 연결할 수 없으면 마지막으로 저장된 캐시로 오프라인 시작
+bool ModelLoader::trainFromDatabase(DbManager& db) {
+    // 1. 초기화
+    const QString cachePath = galleryCachePath();
+    Gallery loaded;
+    GalleryFingerprint cachedFp;
+
+    // 2. DB 연결 (실패 → 마지막 캐시)
+    qint64 t = report->now();
+    const bool connected = db.open();
+    report->mark("model.db-connect", t);
+    if (!connected) {
+        t = report->now();
+        const bool cached = loadGalleryCache(cachePath, loaded, cachedFp);
+        report->mark("model.cache-load", t);
+        if (cached)
+            return trainGallery(std::move(loaded), QString("오프라인 캐시, %1").arg(cachedFp.toString()));
+        emit statusChanged("DB 연결 실패");
+        return false;
+    }
+
+    // 3. 스냅샷 지문 비교 → 같으면 캐시 적재
+    GalleryFingerprint fp;
+    QString err;
+    t = report->now();
+    const bool fpOk = queryGalleryFingerprint(db.database(), fp, &err);
+    report->mark("model.fingerprint", t);
+    if (!fpOk) {
+        if (loadGalleryCache(cachePath, loaded, cachedFp))
+            return trainGallery(std::move(loaded), QString("오프라인 캐시, %1").arg(cachedFp.toString()));
+        emit statusChanged(QString("DB 조회 실패: %1").arg(err));
+        return false;
+    }
+    t = report->now();
+    const bool cacheHit = peekGalleryCache(cachePath, cachedFp) && cachedFp == fp
+                          && loadGalleryCache(cachePath, loaded, cachedFp);
+    if (cacheHit) {
+        report->mark("model.cache-load", t);
+        return trainGallery(std::move(loaded), "캐시");
+    }
+    if (isInterruptionRequested())
+        return false;
+
+    // 4. DB 전체 적재 (스트리밍 + 병렬 디코딩)
+    GalleryLoadStats stats;
+    t = report->now();
+    const bool loadedOk = loadGalleryFromDb(db.database(), loaded, &err, &stats);
+    report->mark("model.db-load", t);
+    if (!loadedOk) {
+        emit statusChanged(QString("DB 조회 실패: %1").arg(err));
+        return false;
+    }
+    qDebug().noquote() << QString("[Gallery] loaded %1 rows (%2 templates, %3 MB, %4 failed) in %5 ms, %6 rows/s, %7 threads")
+                              .arg(stats.rows).arg(stats.templates).arg(stats.bytes / (1024.0 * 1024.0), 0, 'f', 1).arg(stats.failed)
+                              .arg(stats.ms, 0, 'f', 0).arg(stats.rows * 1000.0 / std::max(stats.ms, 1.0), 0, 'f', 0)
+                              .arg(stats.threads);
+
+    // 5. 학습 → 캐시 저장 (다음 시작부터 지문이 같으면 디코딩 생략)
+    if (!trainGallery(std::move(loaded), "DB"))
+        return false;
+    t = report->now();
+    if (!saveGalleryCache(cachePath, *store->current()->gallery, fp))
+        qWarning() << "[GalleryCache] save failed:" << cachePath;
+    report->mark("model.cache-save", t);
+    return true;
+}
+
+bool ModelLoader::trainGallery(Gallery&& g, const QString& source) {
+    if (g.empty()) {
+        emit statusChanged("DB에 등록 데이터가 없습니다");
+        return false;
+    }
+    if (isInterruptionRequested())
+        return false;
+
+    // 학습 (선택된 백엔드: FACE_RECOGNIZER / SHADOW_RECOGNIZER)
+    const qint64 t = report->now();
+    QElapsedTimer clock;
+    clock.start();
+    std::unique_ptr<FaceRecognizer> recognizer = createFaceRecognizer();
+    if (!recognizer->train(g.images, g.labels)) {
+        emit statusChanged(QString("%1 학습 오류").arg(recognizer->name()));
+        return false;
+    }
+    report->mark("model.train", t);
+
+    // 원자적 교체: 검출 스레드는 다음 프레임부터 새 모델 사용
+    const QString kind = recognizer->name();
+    auto gallery = std::make_shared<const Gallery>(std::move(g));
+    store->publish(std::move(recognizer), gallery);
+    emit statusChanged(QString("학습(%1) 완료: %2장, 클래스 %3개 [%4, %5 ms]")
+                           .arg(kind)
+                           .arg(gallery->size())
+                           .arg(gallery->classCount())
+                           .arg(source)
+                           .arg(clock.elapsed()));
+    return true;
+}
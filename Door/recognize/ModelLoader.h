@@ -0,0 +1,34 @@
+#pragma once
+#include <QThread>
+#include <QString>
+#include "Gallery.h"
+#include "ModelStore.h"
+
+class DbManager;
+class StartupReport;
+
+// 시작 시 모델 준비 스레드 (GUI/카메라를 막지 않음)
+// - 자체 DB 연결("RecognizeConnection", 이 스레드에서만 사용)
+// - DB 지문이 캐시와 같으면 캐시, 아니면 DB 스트리밍 적재 → 학습 → ModelStore::publish()로 원자적 게시
+// - DB에 연결할 수 없으면 마지막 캐시로 오프라인 시작
+// - 단계별 시간(model.*)은 StartupReport에 기록
+class ModelLoader : public QThread {
+    Q_OBJECT
+public:
+    ModelLoader(ModelStore* store, StartupReport* report, QObject* parent = nullptr);
+    ~ModelLoader() override;
+
+signals:
+    void statusChanged(const QString& s);
+    void loaded(bool ok); // 게시 성공 여부 (실패해도 카메라는 계속 동작)
+
+protected:
+    void run() override;
+
+private:
+    bool trainFromDatabase(DbManager& db);                 // DB(또는 캐시) → 이미지/라벨 로드 → 학습
+    bool trainGallery(Gallery&& g, const QString& source); // 갤러리로 학습 후 게시
+
+    ModelStore* store = nullptr;     // 모델 게시 지점(소유하지 않음)
+    StartupReport* report = nullptr; // 소유하지 않음
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "FaceRecognizer.h"
+#include "Gallery.h"
+
+// 인식 모델 스냅샷: 학습된 인식기 + 그 인식기를 만든 갤러리(라벨 → 이름)
+// 게시 후에는 읽기 전용. 갱신은 항상 새 스냅샷을 만들어 통째로 교체
+struct ModelSnapshot {
+    std::shared_ptr<const FaceRecognizer> recognizer;
+    std::shared_ptr<const Gallery> gallery;
+    quint64 version = 0;
+};
+
+// ---------- 모델 게시 지점 ----------
+// 읽기(검출/인식 스레드, GUI)는 current()로 스냅샷을 잡고 그동안은 교체와 무관하게 사용
+// 쓰기(초기 학습, 갤러리 감시 스레드)는 publish()로 원자적 교체 → 프레임 루프가 학습을 기다리지 않음
+class ModelStore {
+public:
+    std::shared_ptr<const ModelSnapshot> current() const {
+        return std::atomic_load(&snap);
+    }
+
+    void publish(std::shared_ptr<FaceRecognizer> recognizer, std::shared_ptr<const Gallery> gallery) {
+        auto next = std::make_shared<ModelSnapshot>();
+        next->recognizer = std::move(recognizer);
+        next->gallery = std::move(gallery);
+        next->version = ++versions;
+        std::atomic_store(&snap, std::shared_ptr<const ModelSnapshot>(std::move(next)));
+    }
+
+private:
+    std::shared_ptr<const ModelSnapshot> snap;
+    std::atomic<quint64> versions{0};
+};
@@ -0,0 +1,216 @@
+#include "NnMatcher.h"
+#include "ShardedNearest.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NN_HAS_AVX2 1
+#else
+#define NN_HAS_AVX2 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NN_HAS_NEON 1
+#else
+#define NN_HAS_NEON 0
+#endif
+
+namespace {
+
+const int kBlock = 1024; // 조기 중단 검사 간격(바이트)
+
+// ---------- 스칼라 ----------
+std::int64_t ssdScalar(const uchar* a, const uchar* b, int n, std::int64_t bound) {
+    std::int64_t total = 0;
+    for (int off = 0; off < n; off += kBlock) {
+        const int end = std::min(n, off + kBlock);
+        std::uint32_t acc = 0; // 블록 최대 1024*255^2 < 2^32
+        for (int i = off; i < end; ++i) {
+            const int d = (int)a[i] - (int)b[i];
+            acc += (std::uint32_t)(d * d);
+        }
+        total += acc;
+        if (total > bound)
+            return total;
+    }
+    return total;
+}
+
+#if NN_HAS_AVX2
+// ---------- AVX2: |a-b| (u8) → u16 확장 → madd로 제곱합(i32) ----------
+__attribute__((target("avx2")))
+std::int64_t ssdAvx2(const uchar* a, const uchar* b, int n, std::int64_t bound) {
+    const __m256i zero = _mm256_setzero_si256();
+    std::int64_t total = 0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int i = off; i < off + kBlock; i += 32) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            const __m256i d  = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+            const __m256i lo = _mm256_unpacklo_epi8(d, zero);
+            const __m256i hi = _mm256_unpackhi_epi8(d, zero);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(lo, lo));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(hi, hi));
+        }
+        // 8개 i32 레인 합 (레인당 최대 32*2*2*255^2 < 2^31)
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        total += (std::uint32_t)_mm_cvtsi128_si32(s);
+        if (total > bound)
+            return total;
+    }
+    if (off < n)
+        total += ssdScalar(a + off, b + off, n - off, std::numeric_limits<std::int64_t>::max());
+    return total;
+}
+
+bool cpuHasAvx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+#endif
+
+#if NN_HAS_NEON
+// ---------- NEON: vabd → vmull(u16) → vpadal(u32) ----------
+std::int64_t ssdNeon(const uchar* a, const uchar* b, int n, std::int64_t bound) {
+    std::int64_t total = 0;
+    int off = 0;
+    for (; off + kBlock <= n; off += kBlock) {
+        uint32x4_t acc = vdupq_n_u32(0);
+        for (int i = off; i < off + kBlock; i += 16) {
+            const uint8x16_t d = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+            const uint8x8_t dl = vget_low_u8(d);
+            const uint8x8_t dh = vget_high_u8(d);
+            acc = vpadalq_u16(acc, vmull_u8(dl, dl));
+            acc = vpadalq_u16(acc, vmull_u8(dh, dh));
+        }
+        total += vgetq_lane_u32(acc, 0) + (std::uint64_t)vgetq_lane_u32(acc, 1)
+               + vgetq_lane_u32(acc, 2) + (std::uint64_t)vgetq_lane_u32(acc, 3);
+        if (total > bound)
+            return total;
+    }
+    if (off < n)
+        total += ssdScalar(a + off, b + off, n - off, std::numeric_limits<std::int64_t>::max());
+    return total;
+}
+#endif
+
+} // namespace
+
+const char* NnMatcher::kernelName() {
+#if NN_HAS_AVX2
+    if (cpuHasAvx2()) return "avx2";
+#endif
+#if NN_HAS_NEON
+    return "neon";
+#endif
+    return "scalar";
+}
+
+std::int64_t NnMatcher::ssd(const uchar* a, const uchar* b, int n, std::int64_t bound, Kernel k) {
+    if (k == Kernel::Auto) {
+#if NN_HAS_AVX2
+        if (cpuHasAvx2()) return ssdAvx2(a, b, n, bound);
+#endif
+#if NN_HAS_NEON
+        return ssdNeon(a, b, n, bound);
+#endif
+    }
+    return ssdScalar(a, b, n, bound);
+}
+
+NnMatcher::NnMatcher(const NnMatcher& o)
+    : gallery(o.gallery.clone()), labels(o.labels), kernel(o.kernel), parallel(o.parallel) {}
+
+NnMatcher& NnMatcher::operator=(const NnMatcher& o) {
+    if (this != &o) {
+        gallery = o.gallery.clone();
+        labels = o.labels;
+        kernel = o.kernel;
+        parallel = o.parallel;
+    }
+    return *this;
+}
+
+void NnMatcher::clear() {
+    gallery.release();
+    labels.clear();
+}
+
+void NnMatcher::reserve(int n) {
+    if (n <= 0)
+        return;
+    if (gallery.data == nullptr) {
+        gallery.create(n, kDim, CV_8U); // 용량만 확보하고 행 수는 0으로
+        gallery.resize(0);
+    } else {
+        gallery.reserve(n);
+    }
+    labels.reserve(n);
+}
+
+bool NnMatcher::add(const cv::Mat& gray128, int label) {
+    if (gray128.empty() || gray128.type() != CV_8UC1)
+        return false;
+
+    cv::Mat row;
+    if (gray128.size() != cv::Size(kSide, kSide))
+        cv::resize(gray128, row, cv::Size(kSide, kSide));
+    else
+        row = gray128.isContinuous() ? gray128 : gray128.clone();
+
+    gallery.push_back(row.reshape(1, 1)); // 1 x kDim 행 추가 (용량은 Mat이 1.5배씩 확장)
+    labels.push_back(label);
+    return true;
+}
+
+bool NnMatcher::retain(const std::vector<char>& keep, const std::vector<int>& newLabels) {
+    const int kept = (int)std::count_if(keep.begin(), keep.end(), [](char k) { return k != 0; });
+    if ((int)keep.size() != size() || (int)newLabels.size() != kept)
+        return false;
+    if (kept == 0) {
+        clear();
+        return true;
+    }
+
+    if (kept < size()) {
+        cv::Mat next(kept, kDim, CV_8U);
+        for (int i = 0, j = 0; i < size(); ++i) {
+            if (keep[i])
+                gallery.row(i).copyTo(next.row(j++));
+        }
+        gallery = next;
+    }
+    labels = newLabels;
+    return true;
+}
+
+bool NnMatcher::match(const cv::Mat& gray128, int& outLabel, double& outDist) const {
+    if (labels.empty() || gray128.type() != CV_8UC1 || gray128.total() != (size_t)kDim)
+        return false;
+
+    cv::Mat q = gray128;
+    if (!q.isContinuous())
+        q = q.clone();
+    const uchar* query = q.ptr<uchar>();
+    const int n = (int)labels.size();
+    const Kernel k = kernel;
+
+    int bestIndex = -1;
+    std::int64_t bestDist = 0;
+    if (!nearestSharded<std::int64_t>(n, parallel, [&](int i, std::int64_t bound) {
+            return ssd(query, gallery.ptr<uchar>(i), kDim, bound, k);
+        }, bestIndex, bestDist))
+        return false;
+
+    outLabel = labels[bestIndex];
+    outDist = std::sqrt((double)bestDist);
+    return true;
+}
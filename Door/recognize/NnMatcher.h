@@ -0,0 +1,54 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// 최근접 이웃(L2) 매처 — NN 인식기 전용
+// - 갤러리를 하나의 연속 행렬(N x 16384, CV_8U, 행 64바이트 정렬)로 보관
+// - 거리: 제곱차 합(SSD) SIMD 커널 (AVX2 / NEON, 없으면 스칼라), 호출당 할당 없음
+// - 조기 중단: 블록마다 부분합이 현재 최선보다 크면 해당 샘플 포기
+// - 갤러리가 크면 cv::parallel_for_로 구간(shard) 분할, 최선값은 shard 간 공유
+class NnMatcher {
+public:
+    static constexpr int kSide = 128;
+    static constexpr int kDim = kSide * kSide;
+
+    enum class Kernel { Auto, Scalar };
+
+    NnMatcher() = default;
+    // 복사 시 갤러리 행렬도 깊은 복사 (증분 갱신 복제본이 게시된 모델과 버퍼를 공유하지 않도록)
+    NnMatcher(const NnMatcher& o);
+    NnMatcher& operator=(const NnMatcher& o);
+    NnMatcher(NnMatcher&&) = default;
+    NnMatcher& operator=(NnMatcher&&) = default;
+
+    void clear();
+    void reserve(int n);
+    bool add(const cv::Mat& gray128, int label);
+    // keep[i]가 0인 샘플 행 제거 + 남은 샘플 라벨 교체
+    bool retain(const std::vector<char>& keep, const std::vector<int>& newLabels);
+
+    int size() const { return (int)labels.size(); }
+    bool empty() const { return labels.empty(); }
+    const std::vector<int>& labelList() const { return labels; }
+    const cv::Mat& packed() const { return gallery; }
+
+    // 가장 가까운 샘플의 라벨과 L2 거리(sqrt(SSD))
+    bool match(const cv::Mat& gray128, int& outLabel, double& outDist) const;
+
+    // 벤치마크용: 커널/병렬 여부 강제
+    void setKernel(Kernel k) { kernel = k; }
+    void setParallel(bool on) { parallel = on; }
+
+    // 현재 CPU에서 선택되는 커널 이름 ("avx2" / "neon" / "scalar")
+    static const char* kernelName();
+
+    // 두 벡터의 SSD, 부분합이 bound를 넘으면 즉시 반환(반환값 > bound)
+    static std::int64_t ssd(const uchar* a, const uchar* b, int n, std::int64_t bound, Kernel k = Kernel::Auto);
+
+private:
+    cv::Mat gallery;          // N x kDim, CV_8U (연속)
+    std::vector<int> labels;
+    Kernel kernel = Kernel::Auto;
+    bool parallel = true;
+};
@@ -0,0 +1,238 @@
+#include "RecognizeWorker.h"
+#include "Env.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDebug>
+
+RecognizeWorker::RecognizeWorker(LatestFrameSlot* in, BoundedQueue<FrameResult>* out,
+                                 PredictFn predict, ModelVersionFn modelVersion, QObject* parent)
+    : QThread(parent), in(in), out(out), predict(std::move(predict)), modelVersion(std::move(modelVersion)) {
+    detectWidth = envIntOr("DETECT_WIDTH", 640);
+    reportEvery = envIntOr("DETECT_REPORT_EVERY", 0);
+    keyframeInterval = envIntOr("TRACK_KEYFRAME", 10);
+    minTrackConf = envIntOr("TRACK_MIN_CONF", 60) / 100.0;
+}
+
+RecognizeWorker::~RecognizeWorker() {
+    stop();
+}
+
+void RecognizeWorker::stop() {
+    requestInterruption();
+    if (in) in->close(); // 프레임 대기 중이면 깨움
+    wait();
+}
+
+// 검출기 준비 (FACE_DETECTOR 환경변수로 백엔드 선택, 검출 스레드에서 생성)
+void RecognizeWorker::ensureDetectorLoaded() {
+    if (detector && detector->ready())
+        return;
+
+    detector = createFaceDetector();
+    detectorOk.store(detector && detector->ready());
+}
+
+// ---------- 검출 ----------
+// 원본 → 검출 입력(백엔드가 원하는 컬러/gray) + 추적용 gray, 반환: 축소 비율
+double RecognizeWorker::makeDetectInput(const cv::Mat& frame, int width, cv::Mat& detIn, cv::Mat& gray) {
+    if (detector && detector->needsColor()) {
+        const double scale = resizeForDetect(frame, width, detIn);
+        if (detIn.channels() == 3)
+            cv::cvtColor(detIn, gray, cv::COLOR_BGR2GRAY);
+        else
+            gray = detIn; // gray 스트림 (검출기가 내부에서 BGR로 변환)
+        return scale;
+    }
+    const double scale = makeDetectGray(frame, width, gray);
+    detIn = gray;
+    return scale;
+}
+// 축소 영상에서 검출 (결과는 축소 영상 좌표)
+std::vector<cv::Rect> RecognizeWorker::detectOnImage(const cv::Mat& detIn, double scale) {
+    return detector->detect(detIn, scaledMinSize(cv::Size(60,60), scale));
+}
+// 축소 영상에서 검출 후 원본 좌표로 변환
+std::vector<cv::Rect> RecognizeWorker::detectFaces(const cv::Mat& frame, int width, double* outScale) {
+    cv::Mat detIn, gray;
+    const double scale = makeDetectInput(frame, width, detIn, gray);
+    if (outScale) *outScale = scale;
+    return mapRectsToFull(detectOnImage(detIn, scale), scale, frame.size());
+}
+
+// 키프레임이면 전체 검출 + 추적기 재초기화, 아니면 추적만 (실패/저신뢰 시 전체 검출)
+std::vector<cv::Rect> RecognizeWorker::detectOrTrack(const cv::Mat& frame, bool& outTracked) {
+    cv::Mat detIn, gray;
+    const double scale = makeDetectInput(frame, detectWidth, detIn, gray);
+    outTracked = false;
+
+    const bool trackOn = keyframeInterval > 1;
+    if (trackOn && tracker.active() && sinceKeyframe < keyframeInterval - 1) {
+        cv::Rect r;
+        if (tracker.update(gray, r) && tracker.confidence() >= minTrackConf) {
+            sinceKeyframe++;
+            trackRuns++;
+            outTracked = true;
+            return mapRectsToFull({r}, scale, frame.size());
+        }
+    }
+
+    // 전체 검출(키프레임)
+    std::vector<cv::Rect> found = detectOnImage(detIn, scale);
+    detectRuns++;
+    sinceKeyframe = 0;
+    if (trackOn && found.size() == 1)
+        tracker.init(gray, found.front()); // 추적기는 1명만 → 여러 명이면 매 프레임 전체 검출
+    else
+        tracker.reset();
+
+    if ((detectRuns + trackRuns) % 300 == 0)
+        qDebug() << "[Track] full detect:" << detectRuns << "tracked:" << trackRuns
+                 << "| detector" << detector->name() << "avg" << detector->avgMs() << "ms";
+    return mapRectsToFull(found, scale, frame.size());
+}
+
+// 같은 프레임을 여러 검출 폭으로 돌려 원본 대비 속도/재현율 누적
+void RecognizeWorker::measureScales(const cv::Mat& frame) {
+    static const int widths[] = {0, 960, 640, 480, 320};
+
+    QElapsedTimer clock;
+    clock.start();
+    const std::vector<cv::Rect> truth = detectFaces(frame, 0);
+    scaleReport.add(0, 1.0, clock.nsecsElapsed() / 1e6, truth, truth);
+
+    for (int w : widths) {
+        if (w == 0 || w >= frame.cols)
+            continue;
+        double scale = 1.0;
+        clock.restart();
+        const std::vector<cv::Rect> found = detectFaces(frame, w, &scale);
+        scaleReport.add(w, scale, clock.nsecsElapsed() / 1e6, found, truth);
+    }
+    scaleReport.countFrame();
+
+    if (scaleReport.samples() % 20 == 0)
+        qDebug().noquote() << scaleReport.summary();
+}
+
+// ---------- 인식: 트랙 id → 필요한 얼굴만 배치 예측 → 나머지는 캐시 ----------
+void RecognizeWorker::recognizeFaces(const cv::Mat& frame, qint64 nowMs, FrameResult& res) {
+    std::vector<cv::Rect> rects;
+    for (const FaceResult& f : res.faces)
+        rects.push_back(f.rect);
+    identities.setModelVersion(modelVersion ? modelVersion() : 0);
+    identities.assign(rects, nowMs, trackIds);
+    if (res.faces.empty() || !predict)
+        return;
+
+    // 1. 다시 예측할 얼굴만 모음 (새 트랙 / 주기 도래 / 많이 움직임 / 모델 교체)
+    pendingFaces.clear();
+    pendingRects.clear();
+    for (size_t i = 0; i < res.faces.size(); ++i) {
+        res.faces[i].trackId = trackIds[i];
+        res.faces[i].cached = true; // 예측하면 아래에서 false
+        if (identities.needsPredict(trackIds[i], rects[i], nowMs)) {
+            pendingFaces.push_back((int)i);
+            pendingRects.push_back(rects[i]);
+        }
+    }
+
+    // 2. 원본 해상도 ROI를 128x128 그레이 배치로 만들어 한 번에 입력
+    const quint64 predictedBefore = identities.predictedCount();
+    if (!pendingRects.empty()) {
+        QElapsedTimer predictClock;
+        predictClock.start();
+        makeFaceBatch(frame, pendingRects, rois);
+        predict(rois, predictions);
+        for (size_t k = 0; k < pendingFaces.size() && k < predictions.size(); ++k) {
+            identities.store(trackIds[pendingFaces[k]], pendingRects[k], predictions[k], nowMs);
+            res.faces[pendingFaces[k]].cached = false;
+        }
+        res.predictMs = predictClock.nsecsElapsed() / 1e6;
+        res.predictions = (int)pendingRects.size();
+    }
+
+    // 3. 모든 얼굴은 트랙의 (방금 갱신했거나 캐시된) 예측을 사용
+    for (FaceResult& f : res.faces) {
+        FacePrediction p;
+        if (!identities.lookup(f.trackId, p))
+            continue;
+        f.predicted = p.ok;
+        f.label = p.label;
+        f.score = p.score;
+        if (f.cached)
+            identities.countReused();
+    }
+
+    // 예측 100회마다 캐시 효과 보고
+    if (identities.predictedCount() / 100 != predictedBefore / 100) {
+        const quint64 total = identities.predictedCount() + identities.reusedCount();
+        qDebug().noquote() << QString("[Identity] predicted %1 / reused %2 (%3% cached)")
+                                  .arg(identities.predictedCount()).arg(identities.reusedCount())
+                                  .arg(100.0 * identities.reusedCount() / total, 0, 'f', 1);
+    }
+}
+
+// ---------- 프레임 1장 처리: 검출 → 예측 ----------
+FrameResult RecognizeWorker::process(FramePacket& pkt) {
+    QElapsedTimer clock;
+    clock.start();
+
+    FrameResult res;
+    res.seq = pkt.seq;
+    res.tsMs = pkt.tsMs;
+    res.skipped = skipped;
+    cv::Mat& frame = pkt.frame;
+
+    // 얼굴 검출 (축소 영상) → 원본 좌표
+    if (detectorOk.load()) {
+        if (reportEvery > 0 && pkt.seq % reportEvery == 0)
+            measureScales(frame);
+        for (const cv::Rect& r : detectOrTrack(frame, res.tracked))
+            res.faces.push_back(FaceResult{r});
+        res.detectMs = res.tracked ? 0.0 : detector->lastMs();
+    }
+    // 예측: 트랙별 신원 캐시, 필요한 얼굴만 배치 예측
+    recognizeFaces(frame, pkt.tsMs, res);
+    // 표시용 박스는 ROI 추출 이후에 그림
+    // gray 스트림(이미 DETECT_WIDTH 이하)은 frame 버퍼가 추적기의 prevGray와 같으므로 복사본에 그림
+    // (원본에 그리면 다음 광류가 박스 테두리를 따라감), BGR 프레임은 추적용 gray가 별도 버퍼라 그대로 그림
+    cv::Mat shown = frame.channels() == 1 ? frame.clone() : frame;
+    for (const FaceResult& f : res.faces)
+        cv::rectangle(shown, f.rect, shown.channels() == 1 ? cv::Scalar(255) : cv::Scalar(0,255,0), 2);
+
+    res.frame = shown;
+    res.procMs = clock.elapsed();
+    return res;
+}
+
+// ---------- 검출 루프 ----------
+void RecognizeWorker::run() {
+    ensureDetectorLoaded();
+    detectorRetry.start();
+    emit statusChanged(detectorOk.load()
+                           ? QString("카메라 시작됨 (얼굴 인식 가능, 검출기: %1)").arg(detector->name())
+                           : QString("카메라 시작됨 (얼굴 인식 불가능)"));
+
+    while (!isInterruptionRequested()) {
+        // 검출기가 없으면 1초마다 다시 준비 (기존 틱마다 cascade 재시도와 같은 복구, 빈도만 제한)
+        if (!detectorOk.load() && detectorRetry.elapsed() >= 1000) {
+            detectorRetry.restart();
+            ensureDetectorLoaded();
+            if (detectorOk.load())
+                emit statusChanged(QString("얼굴 인식 가능 (검출기: %1)").arg(detector->name()));
+        }
+
+        FramePacket pkt;
+        if (!in->waitLatest(pkt, lastSeq, 100))
+            continue;
+        if (lastSeq != 0 && pkt.seq > lastSeq + 1)
+            skipped += pkt.seq - lastSeq - 1;
+        lastSeq = pkt.seq;
+
+        out->push(process(pkt)); // GUI가 밀리면 가장 오래된 결과 버림
+
+        // GUI 알림은 처리 전까지 한 번만 (이벤트 큐가 쌓이지 않도록)
+        if (!notifyPending.exchange(true))
+            emit resultReady();
+    }
+}
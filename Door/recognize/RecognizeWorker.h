@@ -0,0 +1,91 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QThread>
+#include <QString>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "BoundedQueue.h"
+#include "FrameTypes.h"
+#include "LatestFrameSlot.h"
+#include "DetectScale.h"
+#include "FaceTracker.h"
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+#include "FaceIdentity.h"
+
+// 검출/인식 스레드
+// - 최신 프레임 슬롯에서 가장 최근 프레임을 꺼내 얼굴 검출 + 모든 얼굴을 한 배치로 예측(얼굴별 병렬)
+// - 검출은 DETECT_WIDTH 폭으로 축소한 gray에서, 인식 ROI는 원본 해상도에서 자름
+// - 얼굴이 1개일 때만 키프레임 사이에 전체 검출 대신 광류 추적기로 따라감(여러 명이면 매 프레임 검출)
+// - 얼굴마다 트랙 id + 신원 캐시(FaceIdentity.h): 새 얼굴/주기 도래/많이 움직인 얼굴만 예측
+// - 결과는 결과 큐에 넣고 resultReady()로 GUI에 알림(Queued)
+class RecognizeWorker : public QThread {
+    Q_OBJECT
+public:
+    // 예측 함수: gray 128x128 배치 → 얼굴별 (성공, 라벨, 점수). 학습 완료 후에는 읽기 전용으로 호출됨
+    using PredictFn = std::function<void(const std::vector<cv::Mat>& roisGray128, std::vector<FacePrediction>& out)>;
+    // 현재 모델 버전 (바뀌면 신원 캐시 무효화), 없으면 캐시는 시간/움직임으로만 갱신
+    using ModelVersionFn = std::function<quint64()>;
+
+    RecognizeWorker(LatestFrameSlot* in, BoundedQueue<FrameResult>* out,
+                    PredictFn predict, ModelVersionFn modelVersion = ModelVersionFn(), QObject* parent = nullptr);
+    ~RecognizeWorker() override;
+
+    void stop(); // 스레드 종료 요청 + 대기
+
+    // GUI가 결과 큐를 비우기 직전에 호출 (다음 결과부터 다시 알림)
+    void clearNotify() { notifyPending.store(false); }
+
+    bool detectorReady() const { return detectorOk.load(); }
+
+signals:
+    void resultReady(); // 결과 큐에 새 항목 있음 (알림이 쌓이지 않도록 1회만)
+    void statusChanged(const QString& s);
+
+protected:
+    void run() override;
+
+private:
+    LatestFrameSlot* in = nullptr;            // 캡처 → 검출 (소유하지 않음)
+    BoundedQueue<FrameResult>* out = nullptr; // 검출 → GUI (소유하지 않음)
+    PredictFn predict;
+    ModelVersionFn modelVersion;
+    std::atomic<bool> notifyPending{false};
+    std::atomic<bool> detectorOk{false};
+    quint64 lastSeq = 0;  // 마지막으로 처리한 프레임 순번
+    quint64 skipped = 0;  // 이 소비자가 건너뛴 프레임 수(순번 간격)
+
+    // 얼굴 검출 (검출 스레드 전용, FACE_DETECTOR로 백엔드 선택)
+    std::unique_ptr<FaceDetector> detector;
+    QElapsedTimer detectorRetry;  // 검출기 준비 실패 시 다시 시도 간격(1초, 모델 파일이 나중에 생겨도 재시작 없이 복구)
+    int detectWidth = 640;        // 검출 영상 폭(0=원본), 환경변수 DETECT_WIDTH
+    int reportEvery = 0;          // N프레임마다 축소 비율별 속도/재현율 측정(0=끔), DETECT_REPORT_EVERY
+    DetectScaleReport scaleReport;
+
+    // 얼굴 추적 (키프레임 사이 검출 생략)
+    FaceTracker tracker;
+    int keyframeInterval = 10;    // N프레임마다 전체 검출(1 이하=추적 끔), TRACK_KEYFRAME
+    double minTrackConf = 0.6;    // 추적 신뢰도 하한(미만이면 즉시 전체 검출), TRACK_MIN_CONF(%)
+    int sinceKeyframe = 0;        // 마지막 전체 검출 이후 추적한 프레임 수
+    quint64 detectRuns = 0;       // 전체 검출 횟수(통계)
+    quint64 trackRuns = 0;        // 추적으로 대체한 횟수(통계)
+
+    // 신원 캐시 + 배치 예측 버퍼 (프레임마다 재사용)
+    FaceIdentityCache identities;
+    std::vector<int> trackIds;
+    std::vector<int> pendingFaces;     // 이번 프레임에 예측할 얼굴 번호
+    std::vector<cv::Rect> pendingRects;
+    std::vector<cv::Mat> rois;
+    std::vector<FacePrediction> predictions;
+
+    void ensureDetectorLoaded();
+    double makeDetectInput(const cv::Mat& frame, int width, cv::Mat& detIn, cv::Mat& gray);
+    std::vector<cv::Rect> detectOnImage(const cv::Mat& detIn, double scale);
+    std::vector<cv::Rect> detectFaces(const cv::Mat& frame, int width, double* outScale = nullptr);
+    std::vector<cv::Rect> detectOrTrack(const cv::Mat& frame, bool& outTracked);
+    void measureScales(const cv::Mat& frame);
+    void recognizeFaces(const cv::Mat& frame, qint64 nowMs, FrameResult& res);
+    FrameResult process(FramePacket& pkt);
+};
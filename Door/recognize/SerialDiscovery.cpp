@@ -0,0 +1,165 @@
+#include "SerialDiscovery.h"
+#include "SerialLink.h"
+#include "Env.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QRandomGenerator>
+#include <QSerialPortInfo>
+#include <algorithm>
+
+namespace {
+
+// 블루투스(rfcomm) 우선 포트 자동 탐색
+QString pickBtPort() {
+#ifdef Q_OS_LINUX
+    // 1. 고정 바인딩(rfcomm4)
+    if (QFile::exists("/dev/rfcomm4"))
+        return "/dev/rfcomm4";
+#endif
+    // 2. rfcomm 계열/블루투스
+    const auto ports = QSerialPortInfo::availablePorts();
+    for (const auto& info : ports) {
+        const QString name = info.systemLocation();   // /dev/rfcomm1, /dev/ttyACM0 등
+        const QString desc = info.description();      // "Bluetooth Device", "HC-06" 등
+        const QString manf = info.manufacturer();     // "Silicon Labs", "Bluetooth" 등
+        if (name.contains("rfcomm")
+            || desc.contains("HC-06", Qt::CaseInsensitive)
+            || desc.contains("BT04", Qt::CaseInsensitive)
+            || manf.contains("Bluetooth", Qt::CaseInsensitive))
+        {
+            return name;
+        }
+    }
+    // 3. 유선 USB(아두이노)
+    for (const auto& info : ports) {
+        const QString name = info.systemLocation();
+        if (name.contains("ttyACM") || name.contains("ttyUSB"))
+            return name;
+    }
+#ifdef Q_OS_LINUX
+    if (QFile::exists("/dev/ttyACM0"))
+        return "/dev/ttyACM0";
+#endif
+    return {};
+}
+
+} // namespace
+
+SerialDiscovery::SerialDiscovery(SerialLink* link, int baud, QObject* parent)
+    : QObject(parent), link(link), baud(baud), retryTimer(this), hotplugTimer(this) {
+    qRegisterMetaType<SerialState>("SerialState");
+    retryTimer.setSingleShot(true);
+    hotplugTimer.setSingleShot(true);
+    hotplugTimer.setInterval(300);
+    connect(&retryTimer, &QTimer::timeout, this, &SerialDiscovery::attempt);
+    connect(&hotplugTimer, &QTimer::timeout, this, [this]() {
+        // 장치가 새로 생기면 백오프 처음부터
+        failures = 0;
+        attempt();
+    });
+
+    connect(link, &SerialLink::portOpened, this, [this](const QString& port, int) {
+        failures = 0;
+        cachedPort = port;
+        setState(SerialState::Connected, port);
+    });
+    connect(link, &SerialLink::portLost, this, [this](const QString& err) {
+        scheduleRetry(QString("끊김: %1").arg(err));
+    });
+}
+
+void SerialDiscovery::start() {
+#ifdef Q_OS_LINUX
+    if (!watcher) {
+        watcher = new QFileSystemWatcher(this);
+        if (watcher->addPath("/dev"))
+            connect(watcher, &QFileSystemWatcher::directoryChanged, this, &SerialDiscovery::onDevChanged);
+        else
+            qWarning() << "[Serial] cannot watch /dev, hotplug falls back to retry polling";
+        lastDevNodes = serialDevNodes();
+    }
+#endif
+    attempt();
+}
+
+void SerialDiscovery::stop() {
+    retryTimer.stop();
+    hotplugTimer.stop();
+    if (watcher) {
+        delete watcher;
+        watcher = nullptr;
+    }
+}
+
+// ---------- 상태 ----------
+void SerialDiscovery::setState(SerialState s, const QString& port, const QString& detail) {
+    state = s;
+    currentPort = port;
+    emit stateChanged(s, port, detail);
+}
+
+// ---------- 탐색 + 열기 ----------
+QStringList SerialDiscovery::candidates() const {
+    QStringList out;
+    if (!cachedPort.isEmpty() && QFile::exists(cachedPort))
+        out << cachedPort;
+    const QString picked = pickBtPort();
+    if (!picked.isEmpty() && !out.contains(picked))
+        out << picked;
+    return out;
+}
+
+void SerialDiscovery::attempt() {
+    if (state == SerialState::Connected || state == SerialState::Connecting)
+        return;
+    retryTimer.stop();
+
+    setState(SerialState::Searching, QString());
+    const QStringList ports = candidates();
+    if (ports.isEmpty()) {
+        scheduleRetry("사용 가능한 시리얼 포트를 찾지 못했습니다. (/dev/rfcomm4 바인딩 확인)");
+        return;
+    }
+
+    // 열기는 이 스레드에서 바로 (성공하면 portOpened → Connected)
+    QString lastError;
+    for (const QString& port : ports) {
+        setState(SerialState::Connecting, port);
+        if (link->openPort(port, baud))
+            return;
+        lastError = QString("%1 열기 실패").arg(port);
+    }
+    scheduleRetry(lastError);
+}
+
+void SerialDiscovery::scheduleRetry(const QString& reason) {
+    const int baseMs = std::max(100, envIntOr("SERIAL_RETRY_MS", 500));
+    const int maxMs = std::max(baseMs, envIntOr("SERIAL_RETRY_MAX_MS", 30000));
+    const int step = std::min(failures++, 16);
+    const qint64 delay = std::min<qint64>(maxMs, qint64(baseMs) << step);
+    const int jitter = int(delay / 5); // ±20%
+    const int ms = int(delay) + (jitter > 0 ? QRandomGenerator::global()->bounded(-jitter, jitter + 1) : 0);
+
+    setState(SerialState::Waiting, QString(), QString("%1 → %2초 후 재시도").arg(reason).arg(ms / 1000.0, 0, 'f', 1));
+    retryTimer.start(ms);
+}
+
+// ---------- 핫플러그 ----------
+// /dev 전체 변경 중 시리얼 노드(rfcomm*/ttyACM*/ttyUSB*)가 바뀐 경우만 반응
+QStringList SerialDiscovery::serialDevNodes() {
+    QStringList nodes = QDir("/dev").entryList({"rfcomm*", "ttyACM*", "ttyUSB*"}, QDir::System | QDir::Files);
+    nodes.sort();
+    return nodes;
+}
+
+void SerialDiscovery::onDevChanged() {
+    const QStringList nodes = serialDevNodes();
+    if (nodes == lastDevNodes)
+        return;
+    qDebug().noquote() << "[Serial] hotplug:" << nodes.join(' ');
+    lastDevNodes = nodes;
+    if (state != SerialState::Connected && state != SerialState::Connecting)
+        hotplugTimer.start();
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class QFileSystemWatcher;
+class SerialLink;
+
+// 시리얼 연결 상태 (GUI 표시/시작 단계 기록용)
+enum class SerialState {
+    Searching,  // 포트 찾는 중
+    Connecting, // 포트 열기 시도 중
+    Connected,
+    Waiting     // 실패 후 재시도 대기(백오프) 또는 포트 없음
+};
+Q_DECLARE_METATYPE(SerialState)
+
+// ---------- 시리얼 장치 탐색/재연결 (시리얼 I/O 스레드, SerialLink와 같은 스레드) ----------
+// 프레임 루프는 상태만 보고 명령을 보냄 → 포트 목록 조회(QSerialPortInfo::availablePorts)는 끊겨 있을 때 여기서만
+// - 후보: 마지막으로 연결됐던 포트(캐시) → /dev/rfcomm4 고정 바인딩 → rfcomm/블루투스 → ttyACM/ttyUSB
+// - 실패/끊김 시 지수 백오프 + 지터로 재시도: SERIAL_RETRY_MS(기본 500) ~ SERIAL_RETRY_MAX_MS(기본 30000)
+// - Linux: /dev 디렉터리 감시(udev가 rfcomm*/ttyACM*/ttyUSB* 노드를 만들고 지울 때) → 백오프를 무시하고 바로 시도
+class SerialDiscovery : public QObject {
+    Q_OBJECT
+public:
+    explicit SerialDiscovery(SerialLink* link, int baud = 9600, QObject* parent = nullptr);
+
+public slots:
+    void start(); // I/O 스레드에서 호출 (queued)
+    void stop();
+
+signals:
+    void stateChanged(SerialState state, const QString& port, const QString& detail);
+
+private:
+    SerialLink* link = nullptr; // 같은 스레드, 소유하지 않음
+    int baud = 9600;
+    SerialState state = SerialState::Waiting;
+    QString cachedPort;          // 마지막으로 연결됐던 포트
+    QString currentPort;
+    int failures = 0;            // 연속 실패 (백오프 단계)
+    QTimer retryTimer;
+    QTimer hotplugTimer;         // /dev 변경 묶음 처리 (노드 생성 직후 권한 설정 대기)
+    QFileSystemWatcher* watcher = nullptr;
+    QStringList lastDevNodes;    // 마지막으로 본 시리얼 노드 (변경 판단)
+
+    void attempt();
+    void scheduleRetry(const QString& reason);
+    void setState(SerialState s, const QString& port, const QString& detail = QString());
+    void onDevChanged();
+    QStringList candidates() const;
+    static QStringList serialDevNodes();
+};
@@ -0,0 +1,91 @@
+#include "SerialFrame.h"
+
+namespace SerialFrame {
+
+quint8 crc8(const quint8* data, int n) {
+    quint8 crc = 0;
+    for (int i = 0; i < n; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80) ? quint8((crc << 1) ^ 0x07) : quint8(crc << 1);
+    }
+    return crc;
+}
+
+QByteArray encode(quint8 seq, quint8 op, const quint8* payload, int len) {
+    len = qBound(0, len, kMaxPayload);
+    QByteArray f;
+    f.reserve(len + 5);
+    f.append(char(kSync));
+    f.append(char(len));
+    f.append(char(seq));
+    f.append(char(op));
+    if (len > 0)
+        f.append(reinterpret_cast<const char*>(payload), len);
+    f.append(char(crc8(reinterpret_cast<const quint8*>(f.constData()) + 1, len + 3)));
+    return f;
+}
+
+bool Decoder::push(quint8 b, Frame& out) {
+    // 1. 동기 바이트 찾기 (프레임 밖 바이트는 잡음)
+    if (have == 0) {
+        if (b == kSync)
+            have = 1;
+        return false;
+    }
+
+    // 2. 길이 → 순번/opcode/payload/CRC 누적 (길이가 범위 밖이면 깨진 프레임)
+    buf[have - 1] = b;
+    have++;
+    const int len = buf[0];
+    if (len > kMaxPayload) {
+        errors++;
+        have = (b == kSync) ? 1 : 0;
+        return false;
+    }
+    if (have - 1 < len + 4)
+        return false;
+
+    // 3. CRC 확인
+    have = 0;
+    if (crc8(buf, len + 3) != buf[len + 3]) {
+        errors++;
+        return false;
+    }
+    out.len = quint8(len);
+    out.seq = buf[1];
+    out.op = buf[2];
+    for (int i = 0; i < len; ++i)
+        out.payload[i] = buf[3 + i];
+    return true;
+}
+
+QString opName(quint8 op) {
+    switch (op) {
+    case OpOpen:   return "OPEN";
+    case OpClose:  return "CLOSE";
+    case OpStatus: return "STATUS";
+    case OpAck:    return "ACK";
+    case OpAction: return "ACTION";
+    case OpDone:   return "DONE";
+    case OpReed:   return "REED";
+    case OpPhase:  return "PHASE";
+    case OpState:  return "STATE";
+    case OpReady:  return "READY";
+    default:       return QString("OP 0x%1").arg(op, 2, 16, QChar('0'));
+    }
+}
+
+QString ackStatusName(quint8 status) {
+    switch (status) {
+    case AckAccepted: return "accepted";
+    case AckBusy:     return "busy";
+    case AckLockout:  return "lockout";
+    case AckPending:  return "pending";
+    case AckAuto:     return "auto";
+    case AckUnknown:  return "unknown";
+    default:          return QString("status %1").arg(status);
+    }
+}
+
+} // namespace SerialFrame
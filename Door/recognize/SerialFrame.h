@@ -0,0 +1,71 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// ---------- 아두이노 프레임 프로토콜 (SERIAL_PROTOCOL=framed, 기본) ----------
+// [0xA5 동기][길이 N][순번][opcode][payload N바이트][CRC8]
+// - CRC8(다항식 0x07, 초기값 0)은 길이~payload 전체에 대해 계산, 어긋나면 다음 동기 바이트부터 다시 찾음
+// - 순번: 호스트 명령은 1~255 순환, 장치가 스스로 보내는 프레임(자동 닫힘/텔레메트리)은 장치 순번
+// - 장치 응답은 명령 순번을 payload 첫 바이트에 담음 → 명령 이름이 아니라 순번으로 짝지음 (0=자동 동작)
+// - 양쪽 모두 고정 버퍼, 수신 중 할당 없음
+// 펌웨어(Arduino_BT_Door, Arduino_BT_Window)에 같은 정의가 들어 있음 → 바꾸면 함께 수정 (tests/tst_serialframe이 바이트 단위로 확인)
+namespace SerialFrame {
+
+constexpr quint8 kSync = 0xA5;
+constexpr int kMaxPayload = 16;
+
+enum Op : quint8 {
+    // 호스트 → 장치
+    OpOpen   = 0x01,
+    OpClose  = 0x02,
+    OpStatus = 0x03,
+    // 장치 → 호스트
+    OpAck    = 0x80, // [명령 순번, AckStatus]
+    OpAction = 0x81, // [명령 순번, 명령 op]  모터 구동 시작
+    OpDone   = 0x82, // [명령 순번, 명령 op, 구동 ms(LE16), 제동 ms(LE16)]  동작 완료 + 모터 시간
+    OpReed   = 0x83, // [1=닫힘(자석 감지), 0=열림]  리드 스위치 안정 상태가 바뀔 때
+    OpPhase  = 0x84, // [0=IDLE 1=DRIVE 2=BRAKE 3=LOCKOUT]  모터 단계가 바뀔 때
+    OpState  = 0x85, // [0=CLOSED 1=OPENED, (문) 리드 1=닫힘, (문) 모터 단계]  STATUS 응답
+    OpReady  = 0x86, // []  부팅 완료
+};
+
+enum AckStatus : quint8 {
+    AckAccepted = 0,
+    AckBusy     = 1, // 모터 회전/제동 중
+    AckLockout  = 2, // 동작 직후 잠금 시간
+    AckPending  = 3, // 문이 열려 있어 닫힘 대기 중 (리드 LOW까지 OPEN 무시)
+    AckAuto     = 4, // 장치가 스스로 처리 (도어락은 자동 닫힘)
+    AckUnknown  = 5, // 모르는 opcode
+};
+
+struct Frame {
+    quint8 seq = 0;
+    quint8 op = 0;
+    quint8 len = 0;
+    quint8 payload[kMaxPayload] = {};
+
+    quint8 byteAt(int i) const { return i < len ? payload[i] : 0; }
+    quint16 le16At(int i) const { return quint16(byteAt(i) | (byteAt(i + 1) << 8)); }
+};
+
+quint8 crc8(const quint8* data, int n);
+QByteArray encode(quint8 seq, quint8 op, const quint8* payload = nullptr, int len = 0);
+
+// 수신 바이트를 하나씩 넣으면 완성된 프레임을 돌려줌 (깨진 프레임/잡음은 버리고 재동기)
+class Decoder {
+public:
+    bool push(quint8 b, Frame& out);
+    void reset() { have = 0; }
+    quint64 crcErrors() const { return errors; }
+
+private:
+    quint8 buf[kMaxPayload + 4] = {}; // 길이, 순번, opcode, payload, CRC (동기 바이트 제외)
+    int have = 0;                     // 0=동기 바이트 대기
+    quint64 errors = 0;
+};
+
+QString opName(quint8 op);
+QString ackStatusName(quint8 status);
+
+} // namespace SerialFrame
@@ -0,0 +1,280 @@
+#include "SerialLink.h"
+#include "Env.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QSerialPort>
+#include <algorithm>
+
+SerialLink::SerialLink(QObject* parent) : QObject(parent), ackTimer(this) {
+    ackTimeoutMs = std::max(100, envIntOr("SERIAL_ACK_TIMEOUT_MS", 3000));
+    protocol = envOr("SERIAL_PROTOCOL", "framed").compare("ascii", Qt::CaseInsensitive) == 0 ? Protocol::Ascii
+                                                                                              : Protocol::Framed;
+    ackTimer.setInterval(200);
+    connect(&ackTimer, &QTimer::timeout, this, &SerialLink::expireStale);
+}
+
+SerialLink::~SerialLink() {
+    if (finished > 0)
+        logSummary();
+}
+
+// ---------- 포트 ----------
+bool SerialLink::openPort(const QString& port, int baud) {
+    if (!serial) {
+        serial = new QSerialPort(this); // I/O 스레드에서 생성
+        connect(serial, &QSerialPort::readyRead, this, &SerialLink::onReadyRead);
+        // 포트가 사라지면(블루투스 끊김/USB 분리) 닫고 알림 → GUI가 다시 탐색
+        connect(serial, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError e) {
+            if (e == QSerialPort::ResourceError || e == QSerialPort::PermissionError) {
+                const QString err = serial->errorString();
+                closePort();
+                emit portLost(err);
+            }
+        });
+    }
+    if (serial->isOpen())
+        serial->close();
+
+    serial->setPortName(port);
+    serial->setBaudRate(baud);                 // HC-06 기본 9600(통신속도)
+    serial->setDataBits(QSerialPort::Data8);
+    serial->setParity(QSerialPort::NoParity);
+    serial->setStopBits(QSerialPort::OneStop);
+    serial->setFlowControl(QSerialPort::NoFlowControl);
+    if (!serial->open(QIODevice::ReadWrite)) {
+        emit portFailed(port, serial->errorString());
+        return false;
+    }
+    rx.clear();
+    decoder.reset();
+    ackTimer.start();
+    emit portOpened(port, baud);
+    return true;
+}
+
+void SerialLink::closePort() {
+    ackTimer.stop();
+    failAll("closed");
+    if (serial && serial->isOpen())
+        serial->close();
+}
+
+// ---------- 명령 ----------
+// 쓰기는 QSerialPort 내부 버퍼에 넣고 바로 반환 (실제 전송은 이 스레드의 이벤트 루프가 처리)
+void SerialLink::send(const QByteArray& cmd, qint64 faceSeenMs, quint64 id) {
+    if (!serial || !serial->isOpen()) {
+        qWarning() << "[Serial] drop" << cmd << "(port closed)";
+        emit commandFinished(id, QString::fromLatin1(cmd), "closed", -1);
+        return;
+    }
+    Pending p;
+    p.cmd = cmd;
+    p.id = id;
+    p.faceSeenMs = faceSeenMs;
+    p.sentMs = QDateTime::currentMSecsSinceEpoch();
+    if (protocol == Protocol::Framed) {
+        if (++nextSeq == 0)
+            nextSeq = 1; // 0은 장치의 자동 동작
+        p.seq = nextSeq;
+        serial->write(SerialFrame::encode(p.seq, cmd == "OPEN" ? SerialFrame::OpOpen : SerialFrame::OpClose));
+    } else {
+        serial->write(cmd + "\n");
+    }
+    if (faceSeenMs > 0)
+        faceToSent.add(p.sentMs - faceSeenMs);
+    if (protocol == Protocol::Ascii && cmd == "CLOSE") {
+        // 닫기는 펌웨어의 리드 스위치 자동 닫힘이 담당, ASCII는 응답 줄이 없음 → 시간 초과까지 기다리지 않음
+        emit commandFinished(id, QString::fromLatin1(cmd), "sent", -1);
+        return;
+    }
+    pending.push_back(p);
+}
+
+// ---------- 응답 ----------
+void SerialLink::onReadyRead() {
+    if (protocol == Protocol::Framed) {
+        const QByteArray bytes = serial->readAll();
+        SerialFrame::Frame f;
+        for (char c : bytes) {
+            if (decoder.push(quint8(c), f))
+                handleFrame(f);
+        }
+        return;
+    }
+
+    rx += serial->readAll();
+    int nl;
+    while ((nl = rx.indexOf('\n')) >= 0) {
+        const QString line = QString::fromLatin1(rx.left(nl)).trimmed();
+        rx.remove(0, nl + 1);
+        if (!line.isEmpty())
+            handleLine(line);
+    }
+    if (rx.size() > 256)
+        rx.clear(); // 줄바꿈 없는 잡음
+}
+
+// 응답 줄 → 가장 오래된 같은 명령과 짝지음
+void SerialLink::handleLine(const QString& line) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto oldest = [this](const QString& cmd) {
+        return std::find_if(pending.begin(), pending.end(),
+                            [&](const Pending& p) { return QString::fromLatin1(p.cmd) == cmd; });
+    };
+
+    QString cmd;
+    if (line.startsWith("ACTION: ")) {
+        cmd = line.mid(8).trimmed();
+        auto it = oldest(cmd);
+        if (it != pending.end() && it->actionMs == 0) {
+            it->actionMs = now;
+            sentToAction.add(now - it->sentMs);
+            return;
+        }
+    } else if (line.startsWith("DONE: ")) {
+        cmd = line.mid(6).trimmed();
+        auto it = oldest(cmd);
+        if (it != pending.end()) {
+            finish(it, "done", now);
+            return;
+        }
+    } else if (line.contains(" IGNORED")) {
+        // "OPEN IGNORED: pending (waiting reed LOW)" → 이유 첫 단어(busy/lockout/pending)를 결과로
+        cmd = line.section(' ', 0, 0);
+        auto it = oldest(cmd);
+        if (it != pending.end()) {
+            const QString why = line.section(':', 1).trimmed().section(' ', 0, 0).toLower();
+            qDebug().noquote() << "[Serial]" << line;
+            finish(it, why == "busy" || why == "lockout" || why == "pending" ? why : QString("ignored"), now);
+            return;
+        }
+    }
+
+    // 보낸 명령과 무관한 줄 (자동 닫힘, 부팅 등)
+    qDebug().noquote() << "[Serial] device:" << line;
+    emit deviceEvent(line);
+}
+
+// ---------- 응답 (framed): 명령 순번으로 짝지음 ----------
+std::deque<SerialLink::Pending>::iterator SerialLink::findSeq(quint8 seq) {
+    if (seq == 0)
+        return pending.end();
+    return std::find_if(pending.begin(), pending.end(), [seq](const Pending& p) { return p.seq == seq; });
+}
+
+void SerialLink::handleFrame(const SerialFrame::Frame& f) {
+    using namespace SerialFrame;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const quint8 cmdSeq = f.byteAt(0);
+
+    switch (f.op) {
+    case OpAck: {
+        auto it = findSeq(cmdSeq);
+        if (it == pending.end())
+            break;
+        sentToAck.add(now - it->sentMs);
+        if (f.byteAt(1) != AckAccepted) {
+            qDebug().noquote() << "[Serial]" << it->cmd << "ignored:" << ackStatusName(f.byteAt(1));
+            const quint8 st = f.byteAt(1);
+            finish(it, st == AckBusy || st == AckLockout || st == AckPending || st == AckAuto ? ackStatusName(st)
+                                                                                            : QString("ignored"),
+                   now);
+        }
+        return;
+    }
+    case OpAction: {
+        auto it = findSeq(cmdSeq);
+        if (it != pending.end() && it->actionMs == 0) {
+            it->actionMs = now;
+            sentToAction.add(now - it->sentMs);
+            return;
+        }
+        break;
+    }
+    case OpDone: {
+        // 텔레메트리: 장치가 millis()로 잰 구동/제동 시간
+        const int driveMs = f.le16At(2);
+        const int brakeMs = f.le16At(4);
+        motorRun.add(driveMs + brakeMs);
+        auto it = findSeq(cmdSeq);
+        if (it != pending.end()) {
+            qDebug().noquote() << QString("[Serial] motor %1: drive %2 ms, brake %3 ms")
+                                      .arg(opName(f.byteAt(1))).arg(driveMs).arg(brakeMs);
+            finish(it, "done", now);
+            return;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    // 보낸 명령과 무관한 프레임 (자동 닫힘, 리드/단계 텔레메트리, 부팅) → ASCII와 비슷한 한 줄로 알림
+    const QString who = cmdSeq ? QString() : QString(" (auto)");
+    QString line;
+    switch (f.op) {
+    case OpAction: line = QString("ACTION: %1%2").arg(opName(f.byteAt(1)), who); break;
+    case OpDone:
+        line = QString("DONE: %1%2 (drive %3 ms, brake %4 ms)")
+                   .arg(opName(f.byteAt(1)), who).arg(f.le16At(2)).arg(f.le16At(4));
+        break;
+    case OpReed:  line = QString("REED: %1").arg(f.byteAt(0) ? "closed" : "open"); break;
+    case OpPhase: {
+        static const char* const phases[] = {"IDLE", "DRIVE", "BRAKE", "LOCKOUT"};
+        line = QString("PHASE: %1").arg(f.byteAt(0) < 4 ? phases[f.byteAt(0)] : "?");
+        break;
+    }
+    case OpState: line = QString("STATE: %1").arg(f.byteAt(0) ? "OPENED" : "CLOSED"); break;
+    case OpReady: line = "READY"; break;
+    default:      line = opName(f.op); break;
+    }
+    if (f.op != OpPhase) // 단계 변화는 동작마다 4번이라 로그 생략
+        qDebug().noquote() << "[Serial] device:" << line;
+    emit deviceEvent(line);
+}
+
+void SerialLink::finish(std::deque<Pending>::iterator it, const QString& result, qint64 nowMs) {
+    qint64 faceMs = -1;
+    if (result == "done") {
+        sentToDone.add(nowMs - it->sentMs);
+        if (it->faceSeenMs > 0) {
+            faceMs = nowMs - it->faceSeenMs;
+            faceToDone.add(faceMs);
+        }
+    }
+    const QString cmd = QString::fromLatin1(it->cmd);
+    const quint64 id = it->id;
+    qDebug().noquote() << QString("[Serial] %1 %2: sent→action %3 ms, sent→end %4 ms%5")
+                              .arg(cmd).arg(result)
+                              .arg(it->actionMs ? QString::number(it->actionMs - it->sentMs) : QString("-"))
+                              .arg(nowMs - it->sentMs)
+                              .arg(faceMs >= 0 ? QString(", face→done %1 ms").arg(faceMs) : QString());
+    pending.erase(it);
+    emit commandFinished(id, cmd, result, faceMs);
+    if (++finished % 10 == 0)
+        logSummary();
+}
+
+void SerialLink::expireStale() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (!pending.empty() && now - pending.front().sentMs > ackTimeoutMs)
+        finish(pending.begin(), "timeout", now);
+}
+
+void SerialLink::failAll(const QString& result) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (!pending.empty())
+        finish(pending.begin(), result, now);
+}
+
+void SerialLink::logSummary() const {
+    qDebug().noquote() << "[Serial] face→sent  " << faceToSent.summary();
+    if (protocol == Protocol::Framed)
+        qDebug().noquote() << "[Serial] sent→ack   " << sentToAck.summary();
+    qDebug().noquote() << "[Serial] sent→action" << sentToAction.summary();
+    qDebug().noquote() << "[Serial] sent→done  " << sentToDone.summary();
+    qDebug().noquote() << "[Serial] face→done  " << faceToDone.summary();
+    if (protocol == Protocol::Framed)
+        qDebug().noquote() << "[Serial] motor run  " << motorRun.summary()
+                           << "| crc errors" << decoder.crcErrors();
+}
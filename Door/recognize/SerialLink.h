@@ -0,0 +1,84 @@
+#pragma once
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <deque>
+#include "LatencyHistogram.h"
+#include "SerialFrame.h"
+
+class QSerialPort;
+
+// ---------- 아두이노 시리얼 채널 (전용 I/O 스레드) ----------
+// GUI/검출 스레드는 명령을 큐에 넣기만 함 (쓰기/flush 대기 없음) → 프레임 처리가 시리얼에 막히지 않음
+// - QSerialPort는 I/O 스레드에서 생성/사용 (MainWindow가 moveToThread 후 queued 호출)
+// - 포트 찾기/열기/재연결은 같은 스레드의 SerialDiscovery가 담당
+// - 프로토콜은 SERIAL_PROTOCOL로 선택 (펌웨어의 SERIAL_FRAMED와 맞춰야 함)
+//     framed(기본): SerialFrame.h 프레임, 응답(ACK/ACTION/DONE)을 명령 순번으로 짝지음
+//                   + 텔레메트리(모터 구동/제동 시간, 리드 스위치 변화, 모터 단계)
+//     ascii       : 줄 단위 "OPEN\n", 응답 줄을 같은 이름의 가장 오래된 명령과 짝지음
+//       "ACTION: OPEN" → 동작 시작, "DONE: OPEN" → 완료, "OPEN IGNORED: <이유>" → 무시됨
+//   짝이 없는 응답(AUTO: ..., 자동 닫힘의 ACTION/DONE, READY, 텔레메트리)은 장치 이벤트로 알림
+// - 응답이 SERIAL_ACK_TIMEOUT_MS(기본 3000) 안에 없으면 시간 초과
+//   ASCII 펌웨어는 CLOSE에 응답하지 않음 → ASCII CLOSE는 기다리지 않고 바로 "sent"로 끝냄
+// - 지연 히스토그램: 얼굴 처음 수락 → 전송, 전송 → ACK(framed), 전송 → ACTION, 전송 → DONE,
+//   얼굴 → DONE(실제 열림까지), 장치가 잰 모터 구동+제동 시간(framed)
+class SerialLink : public QObject {
+    Q_OBJECT
+public:
+    enum class Protocol { Ascii, Framed };
+
+    explicit SerialLink(QObject* parent = nullptr);
+    ~SerialLink() override;
+
+public slots:
+    bool openPort(const QString& port, int baud); // 같은 스레드(SerialDiscovery)에서 직접 호출
+    void closePort();
+    // cmd: "OPEN"/"CLOSE", faceSeenMs: 그 결정을 만든 얼굴이 처음 수락된 캡처 시각(없으면 0)
+    // id: 호출 측 명령 번호 (commandFinished에 그대로 돌려줌 → 늦은 결과를 최신 명령과 구분)
+    void send(const QByteArray& cmd, qint64 faceSeenMs, quint64 id);
+    void logSummary() const;
+
+signals:
+    void portOpened(const QString& port, int baud);
+    void portFailed(const QString& port, const QString& error);
+    void portLost(const QString& error);
+    // result: done / busy / lockout / pending(문이 열려 있어 닫힘 대기) / ignored / auto / timeout / closed / sent(응답 없는 명령)
+    void commandFinished(quint64 id, const QString& cmd, const QString& result, qint64 faceToDoneMs);
+    void deviceEvent(const QString& line);
+
+private:
+    struct Pending {
+        QByteArray cmd;
+        quint64 id = 0;      // 호출 측 명령 번호
+        quint8 seq = 0;      // 프레임 순번 (framed)
+        qint64 faceSeenMs = 0;
+        qint64 sentMs = 0;
+        qint64 actionMs = 0; // ACTION 수신 시각 (0=아직)
+    };
+
+    QSerialPort* serial = nullptr;
+    Protocol protocol = Protocol::Framed;
+    QByteArray rx;                // 줄 단위 파싱 버퍼 (ascii)
+    SerialFrame::Decoder decoder; // 프레임 파싱 (framed)
+    quint8 nextSeq = 0;
+    std::deque<Pending> pending;  // 응답 대기 중인 명령 (보낸 순서)
+    QTimer ackTimer;
+    int ackTimeoutMs = 3000;
+    quint64 finished = 0;
+
+    LatencyHistogram faceToSent;
+    LatencyHistogram sentToAck;
+    LatencyHistogram sentToAction;
+    LatencyHistogram sentToDone;
+    LatencyHistogram faceToDone;
+    LatencyHistogram motorRun;
+
+    void onReadyRead();
+    void handleLine(const QString& line);
+    void handleFrame(const SerialFrame::Frame& f);
+    std::deque<Pending>::iterator findSeq(quint8 seq);
+    void finish(std::deque<Pending>::iterator it, const QString& result, qint64 nowMs);
+    void expireStale();
+    void failAll(const QString& result);
+};
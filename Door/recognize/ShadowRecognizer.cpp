@@ -0,0 +1,99 @@
+#include "ShadowRecognizer.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+ShadowRecognizer::ShadowRecognizer(std::unique_ptr<FaceRecognizer> primary,
+                                   std::unique_ptr<FaceRecognizer> candidate, int sampleEvery)
+    : primary(std::move(primary)), candidate(std::move(candidate)),
+      sampleEvery(sampleEvery > 0 ? sampleEvery : 1) {
+    thresh = this->primary->threshold();
+    pool.setMaxThreadCount(1);
+    qDebug() << "[Shadow] primary" << this->primary->name()
+             << "candidate" << this->candidate->name() << "every" << this->sampleEvery << "predictions";
+}
+
+ShadowRecognizer::~ShadowRecognizer() {
+    pool.waitForDone(); // 진행 중인 후보 예측이 this를 참조하므로 끝날 때까지 대기
+}
+
+bool ShadowRecognizer::train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) {
+    pool.waitForDone();
+    const bool ok = primary->train(images, labels);
+    if (!candidate->train(images, labels))
+        qWarning() << "[Shadow] candidate train failed";
+    return ok;
+}
+
+bool ShadowRecognizer::update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) {
+    pool.waitForDone();
+    const bool ok = primary->update(images, labels);
+    if (!candidate->update(images, labels))
+        qWarning() << "[Shadow] candidate update failed";
+    return ok;
+}
+
+bool ShadowRecognizer::retain(const std::vector<char>& keep, const std::vector<int>& labels) {
+    pool.waitForDone();
+    return primary->retain(keep, labels) && candidate->retain(keep, labels);
+}
+
+std::unique_ptr<FaceRecognizer> ShadowRecognizer::clone() const {
+    std::unique_ptr<FaceRecognizer> p = primary->clone();
+    std::unique_ptr<FaceRecognizer> c = candidate->clone();
+    if (!p || !c)
+        return nullptr;
+    auto copy = std::make_unique<ShadowRecognizer>(std::move(p), std::move(c), sampleEvery);
+    copy->setThreshold(thresh);
+    return copy;
+}
+
+bool ShadowRecognizer::predict(const cv::Mat& gray128, int& outLabel, double& outScore) const {
+    // 1. 주 백엔드 (결과로 사용)
+    QElapsedTimer clock;
+    clock.start();
+    const bool ok = primary->predict(gray128, outLabel, outScore);
+    const double pMs = clock.nsecsElapsed() / 1e6;
+
+    // 2. 샘플 프레임이고 이전 후보 예측이 끝났으면 후보 백엔드 비동기 실행
+    if (!ok || ++calls % sampleEvery != 0 || inFlight.exchange(true))
+        return ok;
+
+    const cv::Mat roi = gray128.clone();
+    const int pLabel = outLabel;
+    const bool pAccept = accepts(outScore); // 판정은 이 래퍼의 임계값 기준
+    pool.start([this, roi, pLabel, pAccept, pMs]() {
+        QElapsedTimer c;
+        c.start();
+        int label = -1;
+        double score = 0.0;
+        const bool cOk = candidate->predict(roi, label, score);
+        const double cMs = c.nsecsElapsed() / 1e6;
+
+        bool report = false;
+        {
+            QMutexLocker lock(&statMtx);
+            stats.samples++;
+            stats.primaryMs += pMs;
+            stats.candidateMs += cMs;
+            if (cOk && label == pLabel) stats.sameLabel++;
+            if ((cOk && candidate->accepts(score)) == pAccept) stats.sameDecision++;
+            report = (stats.samples % 50 == 0);
+        }
+        if (report)
+            qDebug().noquote() << summary();
+        inFlight.store(false);
+    });
+    return ok;
+}
+
+QString ShadowRecognizer::summary() const {
+    QMutexLocker lock(&statMtx);
+    const double n = stats.samples ? (double)stats.samples : 1.0;
+    return QString("[Shadow] %1 samples | %2 %3 ms | %4 %5 ms | label agree %6% | decision agree %7%")
+        .arg(stats.samples)
+        .arg(primary->name()).arg(stats.primaryMs / n, 0, 'f', 2)
+        .arg(candidate->name()).arg(stats.candidateMs / n, 0, 'f', 2)
+        .arg(100.0 * stats.sameLabel / n, 0, 'f', 1)
+        .arg(100.0 * stats.sameDecision / n, 0, 'f', 1);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
+#include "FaceRecognizer.h"
+
+// 섀도 모드 인식기
+// - 결과는 항상 주 백엔드(primary) 것을 사용
+// - N번째 예측마다 같은 ROI를 후보 백엔드(candidate)로 별도 스레드에서 예측
+//   (이전 샘플이 끝나지 않았으면 건너뜀 → 주 경로 지연 없음)
+// - 백엔드별 평균 지연, 라벨/판정 일치율을 주기적으로 로그 출력
+class ShadowRecognizer : public FaceRecognizer {
+public:
+    ShadowRecognizer(std::unique_ptr<FaceRecognizer> primary,
+                     std::unique_ptr<FaceRecognizer> candidate, int sampleEvery);
+    ~ShadowRecognizer() override;
+
+    QString name() const override { return primary->name(); }
+    QString scoreName() const override { return primary->scoreName(); }
+    bool empty() const override { return primary->empty(); }
+    int sampleCount() const override { return primary->sampleCount(); }
+
+    bool train(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override;
+    bool update(const std::vector<cv::Mat>& images, const std::vector<int>& labels) override;
+    bool retain(const std::vector<char>& keep, const std::vector<int>& labels) override; // 두 백엔드 모두 지원할 때만
+    bool predict(const cv::Mat& gray128, int& outLabel, double& outScore) const override;
+    std::unique_ptr<FaceRecognizer> clone() const override; // 두 백엔드 모두 복제 가능할 때만
+
+    QString summary() const;
+
+private:
+    std::unique_ptr<FaceRecognizer> primary;
+    std::unique_ptr<FaceRecognizer> candidate;
+    const int sampleEvery;
+
+    mutable QThreadPool pool;               // 후보 예측 전용(1스레드)
+    mutable std::atomic<quint64> calls{0};
+    mutable std::atomic<bool> inFlight{false};
+
+    // 통계 (mutex 보호)
+    struct Stats {
+        quint64 samples = 0;
+        double primaryMs = 0.0;
+        double candidateMs = 0.0;
+        quint64 sameLabel = 0;     // 두 백엔드 라벨 일치
+        quint64 sameDecision = 0;  // 두 백엔드 수락/거부 판정 일치
+    };
+    mutable QMutex statMtx;
+    mutable Stats stats;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+
+// 갤러리 최근접 탐색 공통 루틴 (NN 매처 / 내장 LBPH 공용)
+// - dist(i, bound): i번째 샘플 거리. 부분합이 bound를 넘으면 중간값(> bound)을 돌려도 됨(조기 중단)
+// - 샘플이 많으면 cv::parallel_for_로 구간(shard) 분할, 최선 거리는 shard 간 공유해 조기 중단 경계로 사용
+// - 거리가 같으면 앞쪽(먼저 등록된) 샘플 우선 → 단일 스레드 결과와 동일
+template <typename Dist, typename DistFn>
+bool nearestSharded(int n, bool parallel, DistFn dist, int& outIndex, Dist& outDist) {
+    constexpr int kMinPerShard = 64;  // shard 당 최소 샘플 수(작은 갤러리는 단일 스레드)
+    constexpr int kMaxShards = 64;
+    struct Best {
+        Dist d = std::numeric_limits<Dist>::max();
+        int index = -1;
+    };
+
+    if (n <= 0)
+        return false;
+
+    std::atomic<Dist> globalBest{std::numeric_limits<Dist>::max()};
+    std::array<Best, kMaxShards> bests;
+
+    int shards = 1;
+    if (parallel && n >= 2 * kMinPerShard)
+        shards = std::min({kMaxShards, n / kMinPerShard, std::max(1, cv::getNumThreads())});
+
+    auto scan = [&](int s) {
+        const int begin = (int)((long long)n * s / shards);
+        const int end = (int)((long long)n * (s + 1) / shards);
+        Best local;
+        for (int i = begin; i < end; ++i) {
+            const Dist bound = std::min(local.d, globalBest.load(std::memory_order_relaxed));
+            const Dist d = dist(i, bound);
+            if (d < local.d) {
+                // 조기 중단된 중간값은 항상 공유 최선보다 크므로 최종 결과에 선택되지 않음
+                local.d = d;
+                local.index = i;
+                Dist g = globalBest.load(std::memory_order_relaxed);
+                while (d < g && !globalBest.compare_exchange_weak(g, d, std::memory_order_relaxed)) {}
+            }
+        }
+        bests[s] = local;
+    };
+
+    if (shards == 1) {
+        scan(0);
+    } else {
+        cv::parallel_for_(cv::Range(0, shards), [&](const cv::Range& r) {
+            for (int s = r.start; s < r.end; ++s)
+                scan(s);
+        }, shards);
+    }
+
+    Best best;
+    for (int s = 0; s < shards; ++s) {
+        if (bests[s].index >= 0 && (bests[s].d < best.d
+                                    || (bests[s].d == best.d && bests[s].index < best.index)))
+            best = bests[s];
+    }
+    if (best.index < 0)
+        return false;
+    outIndex = best.index;
+    outDist = best.d;
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <algorithm>
+
+// ---------- 시작 단계 시간 기록 ----------
+// 단계들이 여러 스레드(GUI, 모델 준비, 시리얼 탐색)에서 동시에 진행
+// → 공통 기준 시각(생성 시점)으로부터 각 단계의 시작/끝(ms)을 기록해 겹침이 보이도록 출력
+class StartupReport {
+public:
+    StartupReport() { clock.start(); }
+
+    qint64 now() const { return clock.elapsed(); }
+
+    // startMs ~ 지금까지를 한 단계로 기록
+    void mark(const QString& phase, qint64 startMs) {
+        const qint64 end = now();
+        QMutexLocker lock(&mutex);
+        phases.push_back(Phase{phase, startMs, end});
+    }
+
+    // 시작 순으로 정렬해 로그 출력, 마지막 단계가 끝난 시각 반환
+    qint64 print() const {
+        QMutexLocker lock(&mutex);
+        QVector<Phase> sorted = phases;
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const Phase& a, const Phase& b) { return a.start < b.start; });
+        qint64 total = 0;
+        qDebug().noquote() << "[Startup] phase                    start ms   end ms   took ms";
+        for (const Phase& p : sorted) {
+            qDebug().noquote() << QString("  %1 %2 %3 %4")
+                                      .arg(p.name, -24).arg(p.start, 8).arg(p.end, 8).arg(p.end - p.start, 9);
+            total = std::max(total, p.end);
+        }
+        qDebug().noquote() << QString("[Startup] all phases done at %1 ms").arg(total);
+        return total;
+    }
+
+private:
+    struct Phase {
+        QString name;
+        qint64 start = 0;
+        qint64 end = 0;
+    };
+
+    QElapsedTimer clock;
+    mutable QMutex mutex;
+    QVector<Phase> phases;
+};
@@ -0,0 +1,127 @@
+#include "StreamPipeline.h"
+#include "Env.h"
+#include <QDebug>
+#include <opencv2/videoio/registry.hpp>
+#include <algorithm>
+#include <vector>
+
+StreamOptions StreamOptions::fromEnv() {
+    StreamOptions o;
+    o.tuned = envIntOr("STREAM_TUNED", 1) != 0;
+    o.width = std::max(0, envIntOr("STREAM_WIDTH", envIntOr("DETECT_WIDTH", 640)));
+    const bool colorDetector = envOr("FACE_DETECTOR").trimmed().toLower() == "yunet";
+    o.gray = envIntOr("STREAM_GRAY", colorDetector ? 0 : 1) != 0;
+    o.latencyMs = std::max(0, envIntOr("STREAM_LATENCY_MS", 0));
+    o.rtspTcp = envIntOr("STREAM_RTSP_TCP", 1) != 0;
+    o.openTimeoutMs = std::max(500, envIntOr("STREAM_OPEN_TIMEOUT_MS", 5000));
+    return o;
+}
+
+QString gstreamerPipeline(const QString& url, const StreamOptions& opt) {
+    QString src;
+    if (url.startsWith("rtsp://", Qt::CaseInsensitive)) {
+        // 지터 버퍼 최소화, 늦은 패킷은 버림 / 연결·수신 타임아웃(µs)은 열기 제한 시간과 같게
+        const qint64 timeoutUs = qint64(opt.openTimeoutMs) * 1000;
+        src = QString("rtspsrc location=\"%1\" latency=%2 drop-on-latency=true timeout=%3 tcp-timeout=%3%4 ! decodebin")
+                  .arg(url).arg(opt.latencyMs).arg(timeoutUs).arg(opt.rtspTcp ? " protocols=tcp" : "");
+    } else {
+        src = QString("uridecodebin uri=\"%1\"").arg(url);
+    }
+
+    // 디코딩 직후 1장짜리 누수 큐: 뒤가 밀리면 오래된 프레임을 버림(항상 최신)
+    QString p = src + " ! queue max-size-buffers=1 max-size-bytes=0 max-size-time=0 leaky=downstream";
+    // 변환 전에 축소 → 색 변환할 픽셀 수가 줄어듦 (높이는 비율 유지로 자동 결정)
+    if (opt.width > 0)
+        p += QString(" ! videoscale ! video/x-raw,width=%1,pixel-aspect-ratio=1/1").arg(opt.width);
+    // GRAY8: YUV 디코더 출력의 Y 평면만 복사 (BGR 변환 없음)
+    p += QString(" ! videoconvert ! video/x-raw,format=%1").arg(opt.gray ? "GRAY8" : "BGR");
+    p += " ! appsink sync=false drop=true max-buffers=1";
+    return p;
+}
+
+void applyFfmpegLowLatency(const StreamOptions& opt) {
+    // 사용자가 OPENCV_FFMPEG_CAPTURE_OPTIONS를 지정했으면 그대로 사용
+    if (!opt.tuned || !qEnvironmentVariableIsEmpty("OPENCV_FFMPEG_CAPTURE_OPTIONS"))
+        return;
+    QByteArray opts = "fflags;nobuffer|flags;low_delay|max_delay;0|reorder_queue_size;0";
+    if (opt.rtspTcp)
+        opts += "|rtsp_transport;tcp";
+    // RTSP 소켓 타임아웃(µs). "timeout"은 FFmpeg 4 이하 RTSP에서 수신 대기(listen) 모드가 되므로 넣지 않음
+    // → 새 FFmpeg은 open 파라미터 CAP_PROP_OPEN_TIMEOUT_MSEC(ffmpegOpenParams)가 제한
+    opts += "|stimeout;" + QByteArray::number(qint64(opt.openTimeoutMs) * 1000);
+    qputenv("OPENCV_FFMPEG_CAPTURE_OPTIONS", opts);
+}
+
+QString openTunedStream(cv::VideoCapture& cap, const QString& url, const StreamOptions& opt) {
+    if (!opt.tuned)
+        return QString();
+
+    // 1) GStreamer: 디코더 쪽 축소 + gray
+    if (cv::videoio_registry::hasBackend(cv::CAP_GSTREAMER)) {
+        const QString pipeline = gstreamerPipeline(url, opt);
+        if (cap.open(pipeline.toStdString(), cv::CAP_GSTREAMER))
+            return QString("GStreamer 저지연, %1, %2")
+                .arg(opt.width > 0 ? QString("%1px").arg(opt.width) : QString("원본"))
+                .arg(opt.gray ? "gray" : "BGR");
+        qDebug().noquote() << "[Stream] tuned GStreamer pipeline failed:" << pipeline;
+    }
+
+    // 2) FFmpeg: 저지연 옵션 (환경변수는 main()에서 미리 설정됨)
+    if (cap.open(url.toStdString(), cv::CAP_FFMPEG, ffmpegOpenParams(opt, true)))
+        return "FFmpeg 저지연";
+    return QString();
+}
+
+std::vector<int> ffmpegOpenParams(const StreamOptions& opt, bool hwAccel) {
+    std::vector<int> params;
+// HW 가속 open 파라미터는 OpenCV 4.5.2부터, 열기/읽기 타임아웃은 4.5.3부터 제공
+#define CV_AT_LEAST(mi, rev) (CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > (mi) || (CV_VERSION_MINOR == (mi) && CV_VERSION_REVISION >= (rev)))))
+#if CV_AT_LEAST(5, 2)
+    if (hwAccel)
+        params.insert(params.end(), {cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY}); // 가능하면 HW 디코딩
+#else
+    (void)hwAccel;
+#endif
+#if CV_AT_LEAST(5, 3)
+    params.insert(params.end(), {cv::CAP_PROP_OPEN_TIMEOUT_MSEC, opt.openTimeoutMs,
+                                 cv::CAP_PROP_READ_TIMEOUT_MSEC, opt.openTimeoutMs});
+#else
+    (void)opt;
+#endif
+#undef CV_AT_LEAST
+    return params;
+}
+
+// ---------- 지연 측정 ----------
+void StreamDelayMeter::add(qint64 arrivalMs, double ptsMs, double decodeMs) {
+    frames++;
+    decodeSum += decodeMs;
+    decodeMax = std::max(decodeMax, decodeMs);
+    if (ptsMs <= 0.0)
+        return; // PTS를 주지 않는 백엔드/스트림
+
+    const double offset = arrivalMs - ptsMs;
+    if (!haveMin || offset < minOffset) {
+        minOffset = offset;
+        haveMin = true;
+    }
+    const double delay = offset - minOffset;
+    ptsFrames++;
+    delaySum += delay;
+    delayMax = std::max(delayMax, delay);
+}
+
+void StreamDelayMeter::reset() {
+    *this = StreamDelayMeter();
+}
+
+QString StreamDelayMeter::takeSummary() {
+    const double n = frames ? (double)frames : 1.0;
+    QString s = QString("decode avg %1 / max %2 ms").arg(decodeSum / n, 0, 'f', 1).arg(decodeMax, 0, 'f', 1);
+    if (ptsFrames > 0)
+        s += QString(" | stream delay(vs best) avg %1 / max %2 ms")
+                 .arg(delaySum / ptsFrames, 0, 'f', 0).arg(delayMax, 0, 'f', 0);
+    frames = ptsFrames = 0;
+    delaySum = delayMax = decodeSum = decodeMax = 0.0;
+    return s;
+}
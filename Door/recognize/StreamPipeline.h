@@ -0,0 +1,56 @@
+#pragma once
+#include <QString>
+#include <opencv2/videoio.hpp>
+#include <vector>
+
+// ---------- 원격 카메라 저지연 열기 ----------
+// 기본 open(url)은 원본 해상도를 CPU에서 디코딩 + BGR 변환한 뒤 대부분을 버림
+// → 디코더 쪽에서 검출 해상도로 축소하고 Y 평면(GRAY8)만 받는 파이프라인을 먼저 시도
+//   1) GStreamer: rtspsrc(latency=0, drop-on-latency) / uridecodebin → 누수(leaky) 큐 → videoscale → GRAY8 → appsink(drop)
+//   2) FFmpeg  : 버퍼링 없는 저지연 옵션(nobuffer, low_delay, RTSP TCP) + 가능하면 HW 디코딩 (축소/gray는 불가)
+//   둘 다 실패하면 호출 측이 기존 기본 열기로 폴백
+// 모든 원격 열기에 명시적 타임아웃(STREAM_OPEN_TIMEOUT_MS): 응답 없는 주소가 기본 네트워크 타임아웃만큼 막지 않도록
+//   GStreamer: rtspsrc timeout/tcp-timeout, FFmpeg: CAP_PROP_OPEN_TIMEOUT_MSEC + stimeout
+struct StreamOptions {
+    bool tuned = true;   // STREAM_TUNED (0이면 기존 방식만)
+    int width = 640;     // 디코더 쪽 축소 폭(0=원본), STREAM_WIDTH (기본 DETECT_WIDTH)
+    bool gray = true;    // GRAY8 출력, STREAM_GRAY (기본: FACE_DETECTOR가 컬러 입력 검출기(yunet)가 아니면 1)
+    int latencyMs = 0;   // rtspsrc 지터 버퍼(ms), STREAM_LATENCY_MS
+    bool rtspTcp = true; // RTSP를 TCP로(패킷 손실로 인한 깨짐 방지), STREAM_RTSP_TCP
+    int openTimeoutMs = 5000; // 열기 시도 하나의 제한 시간, STREAM_OPEN_TIMEOUT_MS
+
+    static StreamOptions fromEnv();
+};
+
+// GStreamer 파이프라인 문자열 (url이 rtsp://면 rtspsrc, 그 외 uridecodebin)
+QString gstreamerPipeline(const QString& url, const StreamOptions& opt);
+
+// FFmpeg open 파라미터: 열기/읽기 타임아웃 (+ hwAccel이면 HW 디코딩), OpenCV 버전에 없는 항목은 생략
+std::vector<int> ffmpegOpenParams(const StreamOptions& opt, bool hwAccel);
+
+// FFmpeg 저지연 옵션을 환경변수(OPENCV_FFMPEG_CAPTURE_OPTIONS)로 설정 (이미 있으면 그대로)
+// OpenCV는 Qt 잠금 밖에서 getenv로 읽음 → main()에서 캡처 스레드 시작 전에 한 번만 호출
+void applyFfmpegLowLatency(const StreamOptions& opt);
+
+// 저지연 열기 시도. 성공 시 사용한 방식 설명, 실패 시 빈 문자열
+QString openTunedStream(cv::VideoCapture& cap, const QString& url, const StreamOptions& opt);
+
+// 스트림 지연 추정: (도착 시각 - 스트림 PTS)에서 관측된 최솟값을 뺀 값
+// → 카메라와 시계가 맞지 않아도 네트워크/디코더/큐에 쌓인 추가 지연을 볼 수 있음(절대값 아님)
+class StreamDelayMeter {
+public:
+    void add(qint64 arrivalMs, double ptsMs, double decodeMs);
+    void reset(); // 재연결(PTS 기준이 바뀜) 시
+    // 구간 요약 후 구간 통계 초기화 (기준 최솟값은 유지)
+    QString takeSummary();
+
+private:
+    double minOffset = 0.0;
+    bool haveMin = false;
+    quint64 frames = 0;
+    quint64 ptsFrames = 0;
+    double delaySum = 0.0;
+    double delayMax = 0.0;
+    double decodeSum = 0.0;
+    double decodeMax = 0.0;
+};
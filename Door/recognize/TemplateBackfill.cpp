@@ -0,0 +1,137 @@
+#include "TemplateBackfill.h"
+#include "DbManager.h"
+#include "Env.h"
+#include "FaceTemplate.h"
+#include "GalleryLoader.h"
+#include <QElapsedTimer>
+#include <QVariantList>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+struct PendingRow {
+    qint64 id = 0;
+    QByteArray png;
+    QByteArray templ; // 디코딩 실패 시 비어 있음
+};
+
+// id > afterId 이고 템플릿이 없거나 버전이 다른 행을 최대 limit개
+bool fetchPending(const QSqlDatabase& db, qint64 afterId, int limit, std::vector<PendingRow>& out, QString* error) {
+    out.clear();
+    QSqlQuery q(db);
+    q.prepare("SELECT id, face_data FROM face_images "
+              "WHERE id > :after AND (template_version IS NULL OR template_version <> :ver "
+              "OR face_template IS NULL OR LENGTH(face_template) <> :bytes) "
+              "ORDER BY id ASC LIMIT :lim");
+    q.bindValue(":after", afterId);
+    q.bindValue(":ver", kFaceTemplateVersion);
+    q.bindValue(":bytes", kFaceTemplateBytes);
+    q.bindValue(":lim", limit);
+    if (!q.exec()) {
+        if (error) *error = q.lastError().text();
+        return false;
+    }
+    while (q.next()) {
+        PendingRow r;
+        r.id = q.value(0).toLongLong();
+        r.png = q.value(1).toByteArray();
+        out.push_back(std::move(r));
+    }
+    return true;
+}
+
+// 성공한 행만 한 트랜잭션으로 갱신
+bool writeTemplates(QSqlDatabase db, const std::vector<PendingRow>& rows, QString* error) {
+    QVariantList templs, vers, ids;
+    for (const PendingRow& r : rows) {
+        if (r.templ.isEmpty())
+            continue;
+        templs << r.templ;
+        vers << kFaceTemplateVersion;
+        ids << r.id;
+    }
+    if (ids.isEmpty())
+        return true;
+
+    db.transaction();
+    QSqlQuery q(db);
+    q.prepare("UPDATE face_images SET face_template = ?, template_version = ? WHERE id = ?");
+    q.addBindValue(templs);
+    q.addBindValue(vers);
+    q.addBindValue(ids);
+    if (!q.execBatch()) {
+        if (error) *error = q.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return db.commit();
+}
+
+} // namespace
+
+int runTemplateBackfill() {
+    const int batch = std::max(1, envIntOr("BACKFILL_BATCH", 256));
+
+    DbManager db("Backfill");
+    if (!db.open())
+        return 1;
+
+    // 1. 스키마
+    QString err;
+    if (!ensureFaceTemplateColumns(db.database(), &err)) {
+        qCritical() << "[Backfill] cannot add template columns:" << err;
+        db.close();
+        return 1;
+    }
+
+    qDebug().noquote() << QString("[Backfill] template v%1, batch %2, threads %3")
+                              .arg(kFaceTemplateVersion).arg(batch).arg(cv::getNumThreads());
+
+    // 2. 배치 반복: 조회 → 병렬 디코딩 → 트랜잭션 갱신
+    QElapsedTimer clock;
+    clock.start();
+    qint64 lastId = 0, done = 0, failed = 0;
+    std::vector<PendingRow> rows;
+    while (true) {
+        if (!fetchPending(db.database(), lastId, batch, rows, &err)) {
+            qCritical() << "[Backfill] query failed:" << err;
+            db.close();
+            return 1;
+        }
+        if (rows.empty())
+            break;
+
+        cv::parallel_for_(cv::Range(0, (int)rows.size()), [&](const cv::Range& r) {
+            for (int i = r.start; i < r.end; ++i) {
+                cv::Mat gray;
+                if (decodeFaceRow(rows[i].png, gray))
+                    rows[i].templ = encodeFaceTemplate(gray);
+                rows[i].png.clear();
+            }
+        });
+
+        if (!writeTemplates(db.database(), rows, &err)) {
+            qCritical() << "[Backfill] update failed:" << err;
+            db.close();
+            return 1;
+        }
+        for (const PendingRow& r : rows) {
+            if (r.templ.isEmpty()) {
+                failed++;
+                qWarning() << "[Backfill] decode failed, id" << r.id;
+            } else {
+                done++;
+            }
+        }
+        lastId = rows.back().id;
+        qDebug().noquote() << QString("[Backfill] up to id %1: %2 done, %3 failed").arg(lastId).arg(done).arg(failed);
+    }
+
+    const double sec = std::max(clock.elapsed(), (qint64)1) / 1000.0;
+    qDebug().noquote() << QString("[Backfill] finished: %1 rows in %2 s (%3 rows/s), %4 failed")
+                              .arg(done).arg(sec, 0, 'f', 1).arg(done / sec, 0, 'f', 0).arg(failed);
+    db.close();
+    return failed ? 2 : 0;
+}
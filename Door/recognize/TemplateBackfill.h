@@ -0,0 +1,10 @@
+#pragma once
+
+// ---------- 템플릿 백필 (GUI 없이 실행) ----------
+// 사용: recognize --backfill-templates
+// - face_template/template_version 컬럼이 없으면 추가
+// - 템플릿이 없거나 버전이 다른 행을 id 순 배치(BACKFILL_BATCH, 기본 256)로 읽어
+//   PNG 디코딩은 병렬(cv::parallel_for_), 갱신은 배치마다 한 트랜잭션
+// - 중간에 끊겨도 다시 실행하면 남은 행부터 이어서 처리
+// 반환: 프로세스 종료 코드
+int runTemplateBackfill();
@@ -1,8 +1,24 @@
-
 #include <QApplication>
 #include "MainWindow.h"
+#include "Bench.h"
+#include "TemplateBackfill.h"
+#include "StreamPipeline.h"
 
 int main(int argc, char *argv[]) {
+    // 벤치마크 모드: recognize --bench <name>
+    if (argc >= 3 && QString(argv[1]) == "--bench") {
+        QCoreApplication core(argc, argv);
+        return runBench(QString(argv[2]));
+    }
+    // 템플릿 백필: recognize --backfill-templates
+    if (argc >= 2 && QString(argv[1]) == "--backfill-templates") {
+        QCoreApplication core(argc, argv);
+        return runTemplateBackfill();
+    }
+
+    // FFmpeg 저지연 옵션은 프로세스 환경변수 → 캡처/탐색 스레드가 시작되기 전에 한 번만 설정
+    applyFfmpegLowLatency(StreamOptions::fromEnv());
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
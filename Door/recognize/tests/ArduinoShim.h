@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <strings.h>
+#include <vector>
+
+// ---------- 호스트용 아두이노 최소 대체 (테스트 전용) ----------
+// 펌웨어 스케치(.ino)를 고치지 않고 그대로 컴파일해서 호스트 SerialFrame과 바이트 단위로 비교하기 위함
+// - millis()는 ArduinoShim::nowMs (테스트가 직접 진행), 핀은 배열 (리드 스위치 입력을 테스트가 정함)
+// - Stream: rx는 테스트가 넣는 수신 바이트, tx는 스케치가 쓴 바이트
+typedef uint8_t byte;
+
+const int LOW = 0;
+const int HIGH = 1;
+const int INPUT = 0;
+const int OUTPUT = 1;
+const int INPUT_PULLUP = 2;
+
+namespace ArduinoShim {
+inline unsigned long nowMs = 0;
+inline int pins[32] = {};
+} // namespace ArduinoShim
+
+inline unsigned long millis() { return ArduinoShim::nowMs; }
+inline void pinMode(int, int) {}
+inline void digitalWrite(int pin, int v) { ArduinoShim::pins[pin] = v; }
+inline int digitalRead(int pin) { return ArduinoShim::pins[pin]; }
+inline void analogWrite(int pin, int v) { ArduinoShim::pins[pin] = v; }
+
+class Stream {
+public:
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+
+    void begin(long) {}
+    int available() { return (int)rx.size(); }
+    int read() {
+        if (rx.empty())
+            return -1;
+        const int c = rx.front();
+        rx.pop_front();
+        return c;
+    }
+    size_t write(const uint8_t* data, size_t n) {
+        tx.insert(tx.end(), data, data + n);
+        return n;
+    }
+    size_t write(uint8_t b) { return write(&b, 1); }
+
+    void print(const char* s) { write(reinterpret_cast<const uint8_t*>(s), std::strlen(s)); }
+    void print(char c) { write(uint8_t(c)); }
+    void print(unsigned long v) { printNumber(v); }
+    void print(long v) { printNumber((unsigned long)v); }
+    void print(unsigned int v) { printNumber(v); }
+    void print(int v) { printNumber((unsigned long)v); }
+    template <typename T>
+    void println(T v) {
+        print(v);
+        println();
+    }
+    void println() { print("\r\n"); }
+
+private:
+    void printNumber(unsigned long v) {
+        char buf[24];
+        std::snprintf(buf, sizeof(buf), "%lu", v);
+        print(buf);
+    }
+};
+
+class HardwareSerial : public Stream {};
+
+class SoftwareSerial : public Stream {
+public:
+    SoftwareSerial(int, int) {}
+};
@@ -0,0 +1,8 @@
+#include "Sketches.h"
+#include "SoftwareSerial.h"
+
+// 도어락 펌웨어 (Arduino_BT_Door) — 함수가 사용 전에 정의되어 있어 프로토타입 없이 컴파일됨
+namespace DoorSketch {
+HardwareSerial Serial;
+#include "BT_door_close_ver2.ino"
+} // namespace DoorSketch
@@ -0,0 +1,16 @@
+#pragma once
+#include "ArduinoShim.h"
+
+// 펌웨어 스케치를 이름공간 하나씩에 그대로 컴파일 (DoorSketch.cpp / WindowSketch.cpp)
+// 전역 상태(모터 단계, 수신 버퍼, 순번)는 프로세스 동안 유지 → 테스트는 한 흐름으로 진행
+namespace DoorSketch {
+extern HardwareSerial Serial; // USB 시리얼 (테스트는 이쪽으로 주고받음)
+void setup();
+void loop();
+} // namespace DoorSketch
+
+namespace WindowSketch {
+extern HardwareSerial Serial;
+void setup();
+void loop();
+} // namespace WindowSketch
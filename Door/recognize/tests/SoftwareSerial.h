@@ -0,0 +1,3 @@
+#pragma once
+// 스케치의 #include <SoftwareSerial.h> → 호스트 대체 (ArduinoShim.h)
+#include "ArduinoShim.h"
@@ -0,0 +1,21 @@
+#include "Sketches.h"
+#include "SoftwareSerial.h"
+
+// 창문 펌웨어 (Arduino_BT_Window)
+// 아두이노 빌드가 자동으로 만드는 함수 프로토타입을 대신 선언 (정의보다 앞에서 호출되는 함수들)
+namespace WindowSketch {
+HardwareSerial Serial;
+struct RxState;
+void stopM();
+void openM();
+void closeM();
+void checkStop();
+const char* stateName();
+void parseLines(Stream& io, RxState& rx);
+void handleLine(Stream& io, const char* s);
+void sendFrame(byte op, const byte* payload, byte len);
+void parseFrames(Stream& io, RxState& rx);
+void handleFrame(byte op, byte seq);
+void printStatus(Stream& io);
+#include "blue_window.ino"
+} // namespace WindowSketch
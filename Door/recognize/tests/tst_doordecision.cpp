@@ -0,0 +1,118 @@
+#include <QtTest>
+#include "DoorDecision.h"
+
+// ---------- 문 열기/닫기 판단 (DoorDecision.h) ----------
+// 프레임 간격 33ms, 구간 200ms / 80%, 끊김 허용 500ms, 닫힘 유예 3000ms, 재시도 1000ms
+class TestDoorDecision : public QObject {
+    Q_OBJECT
+
+private:
+    static DoorObservation face(int track, int label, bool accepted = true) {
+        return DoorObservation{track, label, accepted};
+    }
+
+    // [fromMs, toMs] 동안 stepMs마다 같은 얼굴 → 처음 OPEN이 나온 시각 (없으면 -1)
+    static qint64 firstOpen(DoorDecision& d, qint64 fromMs, qint64 toMs, const DoorObservation& f) {
+        for (qint64 t = fromMs; t <= toMs; t += 33) {
+            if (d.update(t, {f}) == DoorCommand::Open)
+                return t;
+        }
+        return -1;
+    }
+
+private slots:
+    void initTestCase() {
+        qputenv("OPEN_CONFIRM_MS", "200");
+        qputenv("OPEN_VOTE_PCT", "80");
+        qputenv("DOOR_GAP_MS", "500");
+        qputenv("CLOSE_GRACE_MS", "3000");
+        qputenv("DOOR_RETRY_MS", "1000");
+    }
+
+    void opensAfterConfirmWindow() {
+        DoorDecision d;
+        // 첫 샘플이 구간 시작(now - 200) 이전이 되는 첫 프레임: 1000 + 33 * 7
+        QCOMPARE(firstOpen(d, 1000, 2000, face(1, 5)), qint64(1231));
+        QVERIFY(d.lastReason().startsWith("label 5"));
+        QCOMPARE(d.openFaceMs(), qint64(1000));
+    }
+
+    void noOpenWithoutFaces() {
+        DoorDecision d;
+        for (qint64 t = 1000; t <= 3000; t += 33)
+            QCOMPARE(d.update(t, {}), DoorCommand::None);
+        QCOMPARE(firstOpen(d, 3000, 4000, face(1, 5, false)), qint64(-1)); // 미등록 얼굴
+    }
+
+    void voteRatio() {
+        // 수락 1 : 미수락 1 → 50% < 80%
+        DoorDecision half;
+        for (qint64 t = 1000; t <= 3000; t += 33) {
+            const bool acc = ((t - 1000) / 33) % 2 == 0;
+            QCOMPARE(half.update(t, {face(1, 5, acc)}), DoorCommand::None);
+        }
+
+        // 두 라벨이 반씩 → 어느 쪽도 80% 미만
+        DoorDecision split;
+        for (qint64 t = 1000; t <= 3000; t += 33) {
+            const int label = ((t - 1000) / 33) % 2 == 0 ? 5 : 6;
+            QCOMPARE(split.update(t, {face(1, label)}), DoorCommand::None);
+        }
+
+        // 10프레임 중 1프레임만 미수락 → 구간 200ms 안에 미수락은 최대 1개(33ms) → 83% 이상
+        DoorDecision most;
+        bool opened = false;
+        for (qint64 t = 1000; t <= 2000 && !opened; t += 33) {
+            const bool acc = ((t - 1000) / 33) % 10 != 9;
+            opened = most.update(t, {face(1, 5, acc)}) == DoorCommand::Open;
+        }
+        QVERIFY(opened);
+    }
+
+    void shortGapKeepsVotes() {
+        // 1000~1165 관찰 후 285ms 끊김(< 500) → 이어진 첫 프레임에서 구간 전체가 같은 라벨
+        DoorDecision d;
+        QCOMPARE(firstOpen(d, 1000, 1165, face(1, 5)), qint64(-1));
+        QCOMPARE(d.update(1450, {face(1, 5)}), DoorCommand::Open);
+    }
+
+    void longGapResetsVotes() {
+        // 635ms 끊김(> 500) → 표를 버리고 다시 구간 전체를 봐야 함
+        DoorDecision d;
+        QCOMPARE(firstOpen(d, 1000, 1165, face(1, 5)), qint64(-1));
+        QCOMPARE(firstOpen(d, 1800, 3000, face(1, 5)), qint64(1800 + 33 * 7));
+    }
+
+    void closeAfterGrace() {
+        DoorDecision d;
+        QCOMPARE(firstOpen(d, 1000, 2000, face(1, 5)), qint64(1231));
+        d.setOpen(true);
+
+        // 미수락 얼굴은 닫힘 유예를 늘리지 않음, 마지막 수락(1231) + 3000 초과에서 CLOSE
+        QCOMPARE(d.update(2000, {face(2, -1, false)}), DoorCommand::None);
+        QCOMPARE(d.update(4231, {}), DoorCommand::None);
+        QCOMPARE(d.update(4232, {}), DoorCommand::Close);
+    }
+
+    void retryAfterFailedOpen() {
+        DoorDecision d;
+        QCOMPARE(firstOpen(d, 1000, 2000, face(1, 5)), qint64(1231));
+        d.setOpen(true);
+
+        // 장치가 OPEN을 실행하지 않음 → 1000ms 동안은 투표가 통과해도 다시 보내지 않음
+        QCOMPARE(d.openFailed(1300), 1000);
+        QVERIFY(!d.isOpen());
+        QCOMPARE(firstOpen(d, 1264, 3000, face(1, 5)), qint64(1231 + 33 * 33));
+
+        // 연속 실패마다 2배, 최대 8배 / 실행되면 초기화
+        QCOMPARE(d.openFailed(2400), 2000);
+        QCOMPARE(d.openFailed(2500), 4000);
+        QCOMPARE(d.openFailed(2600), 8000);
+        QCOMPARE(d.openFailed(2700), 8000);
+        d.openDone();
+        QCOMPARE(d.openFailed(2800), 1000);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestDoorDecision)
+#include "tst_doordecision.moc"
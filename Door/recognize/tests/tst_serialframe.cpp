@@ -0,0 +1,254 @@
+#include <QtTest>
+#include <vector>
+#include "SerialFrame.h"
+#include "Sketches.h"
+
+using namespace SerialFrame;
+
+// ---------- 프레임 프로토콜 (SerialFrame.h) + 펌웨어와의 바이트 단위 일치 ----------
+class TestSerialFrame : public QObject {
+    Q_OBJECT
+
+private:
+    static std::vector<Frame> decodeAll(const QByteArray& bytes, Decoder& d) {
+        std::vector<Frame> out;
+        Frame f;
+        for (char c : bytes) {
+            if (d.push(quint8(c), f))
+                out.push_back(f);
+        }
+        return out;
+    }
+
+    // 스케치가 보낸 바이트 → 프레임. 호스트 encode()로 다시 만든 바이트와 정확히 같아야 함(잡음/여분 없음)
+    static std::vector<Frame> drain(Stream& s) {
+        const QByteArray tx(reinterpret_cast<const char*>(s.tx.data()), int(s.tx.size()));
+        s.tx.clear();
+        Decoder d;
+        const std::vector<Frame> frames = decodeAll(tx, d);
+        QByteArray again;
+        for (const Frame& f : frames)
+            again += encode(f.seq, f.op, f.payload, f.len);
+        if (again != tx)
+            qWarning() << "device bytes" << tx.toHex(' ') << "host re-encode" << again.toHex(' ');
+        return again == tx ? frames : std::vector<Frame>();
+    }
+
+    static void send(Stream& s, quint8 seq, quint8 op) {
+        const QByteArray f = encode(seq, op);
+        s.rx.insert(s.rx.end(), f.begin(), f.end());
+    }
+
+private slots:
+    void crcKnownVector() {
+        // CRC-8 (다항식 0x07, 초기값 0) 표준 검사값
+        const QByteArray check("123456789");
+        QCOMPARE(crc8(reinterpret_cast<const quint8*>(check.constData()), check.size()), quint8(0xF4));
+    }
+
+    void encodeLayout() {
+        // [동기][길이][순번][opcode][payload][CRC(길이~payload)]
+        const quint8 payload[2] = {0x07, AckBusy};
+        const QByteArray f = encode(0x42, OpAck, payload, 2);
+        QCOMPARE(f.left(6).toHex(' '), QByteArray("a5 02 42 80 07 01"));
+        QCOMPARE(quint8(f.at(6)), crc8(reinterpret_cast<const quint8*>(f.constData()) + 1, 5));
+        QCOMPARE(encode(1, OpReady).toHex(' '), QByteArray("a5 00 01 86 8e"));
+    }
+
+    void roundTrip() {
+        Decoder d;
+        for (int len = 0; len <= kMaxPayload; ++len) {
+            quint8 payload[kMaxPayload];
+            for (int i = 0; i < len; ++i)
+                payload[i] = quint8(i * 37 + len);
+            if (len > 0)
+                payload[0] = kSync; // payload 안의 동기 바이트는 프레임 경계가 아님
+            const std::vector<Frame> frames = decodeAll(encode(quint8(len + 1), OpDone, payload, len), d);
+            QCOMPARE(int(frames.size()), 1);
+            QCOMPARE(frames[0].seq, quint8(len + 1));
+            QCOMPARE(frames[0].op, quint8(OpDone));
+            QCOMPARE(int(frames[0].len), len);
+            QVERIFY(std::equal(payload, payload + len, frames[0].payload));
+        }
+        QCOMPARE(d.crcErrors(), quint64(0));
+    }
+
+    void oversizedPayloadIsClamped() {
+        quint8 payload[kMaxPayload + 4] = {};
+        const QByteArray f = encode(1, OpDone, payload, kMaxPayload + 4);
+        QCOMPARE(int(f.size()), kMaxPayload + 5);
+        Decoder d;
+        QCOMPARE(int(decodeAll(f, d).size()), 1);
+    }
+
+    void noiseBetweenFrames() {
+        Decoder d;
+        const QByteArray bytes = QByteArray("\x00\x13garbage", 9) + encode(1, OpOpen) + QByteArray("\xff\x00", 2)
+                                 + encode(2, OpClose);
+        const std::vector<Frame> frames = decodeAll(bytes, d);
+        QCOMPARE(int(frames.size()), 2);
+        QCOMPARE(frames[0].op, quint8(OpOpen));
+        QCOMPARE(frames[1].op, quint8(OpClose));
+    }
+
+    void resyncAfterBadLength() {
+        // 길이가 범위 밖이면 버리고 다음 동기 바이트부터
+        Decoder d;
+        std::vector<Frame> frames = decodeAll(QByteArray("\xa5\x40", 2) + encode(3, OpOpen), d);
+        QCOMPARE(int(frames.size()), 1);
+        QCOMPARE(frames[0].seq, quint8(3));
+        QCOMPARE(d.crcErrors(), quint64(1));
+
+        // 길이 자리에 동기 바이트가 오면(앞 프레임 잘림) 그 바이트를 새 프레임 시작으로 봄
+        frames = decodeAll(QByteArray("\xa5", 1) + encode(4, OpClose), d);
+        QCOMPARE(int(frames.size()), 1);
+        QCOMPARE(frames[0].seq, quint8(4));
+    }
+
+    void resyncAfterBadCrc() {
+        Decoder d;
+        QByteArray bad = encode(5, OpOpen);
+        bad[bad.size() - 1] = char(bad.at(bad.size() - 1) ^ 0x01);
+        const std::vector<Frame> frames = decodeAll(bad + encode(6, OpOpen), d);
+        QCOMPARE(int(frames.size()), 1);
+        QCOMPARE(frames[0].seq, quint8(6));
+        QCOMPARE(d.crcErrors(), quint64(1));
+    }
+
+    // 도어락 펌웨어: 부팅 → STATUS → OPEN(구동/제동/잠금) → busy/lockout → 문 열림 대기 중 pending
+    void doorFirmwareAgrees() {
+        using namespace DoorSketch;
+        ArduinoShim::nowMs = 0;
+        ArduinoShim::pins[9] = LOW; // 리드 스위치: 닫힘
+        setup();
+        std::vector<Frame> f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].op, quint8(OpReady));
+
+        ArduinoShim::nowMs = 200; // 디바운스 후 리드 안정 상태 보고
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].op, quint8(OpReed));
+        QCOMPARE(f[0].byteAt(0), quint8(1));
+
+        send(Serial, 7, OpStatus);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 2);
+        QCOMPARE(f[0].op, quint8(OpAck));
+        QCOMPARE(f[0].byteAt(0), quint8(7));
+        QCOMPARE(f[0].byteAt(1), quint8(AckAccepted));
+        QCOMPARE(f[1].op, quint8(OpState));
+        QCOMPARE(int(f[1].len), 3);
+
+        send(Serial, 8, OpOpen);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 3); // ACK, ACTION, PHASE(DRIVE)
+        QCOMPARE(f[0].op, quint8(OpAck));
+        QCOMPARE(f[0].byteAt(1), quint8(AckAccepted));
+        QCOMPARE(f[1].op, quint8(OpAction));
+        QCOMPARE(f[1].byteAt(0), quint8(8));
+        QCOMPARE(f[1].byteAt(1), quint8(OpOpen));
+        QCOMPARE(f[2].op, quint8(OpPhase));
+        QCOMPARE(f[2].byteAt(0), quint8(1));
+
+        send(Serial, 9, OpOpen); // 구동 중
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].byteAt(0), quint8(9));
+        QCOMPARE(f[0].byteAt(1), quint8(AckBusy));
+
+        ArduinoShim::nowMs += 850; // OPEN_MS → 제동
+        loop();
+        ArduinoShim::nowMs += 200; // BRAKE_MS → 완료 + 잠금
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 3); // PHASE(BRAKE), DONE, PHASE(LOCKOUT)
+        QCOMPARE(f[1].op, quint8(OpDone));
+        QCOMPARE(f[1].byteAt(0), quint8(8));
+        QCOMPARE(f[1].byteAt(1), quint8(OpOpen));
+        QCOMPARE(f[1].le16At(2), quint16(850));
+        QCOMPARE(f[1].le16At(4), quint16(200));
+
+        send(Serial, 10, OpOpen); // 잠금 시간
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].byteAt(1), quint8(AckLockout));
+
+        // 문을 연 채로 OPEN 신호가 끊기면 닫힘 대기(pending) → 리드가 닫힐 때까지 OPEN 무시
+        ArduinoShim::nowMs += 1500;
+        loop();
+        ArduinoShim::pins[9] = HIGH;
+        ArduinoShim::nowMs += 200;
+        loop();
+        ArduinoShim::nowMs += 3100;
+        loop();
+        drain(Serial);
+        send(Serial, 11, OpOpen);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].byteAt(0), quint8(11));
+        QCOMPARE(f[0].byteAt(1), quint8(AckPending));
+
+        send(Serial, 12, OpClose); // 닫기는 자동 닫힘이 담당
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].byteAt(1), quint8(AckAuto));
+
+        // CRC가 깨진 명령은 응답 없음
+        QByteArray bad = encode(13, OpStatus);
+        bad[bad.size() - 1] = char(bad.at(bad.size() - 1) ^ 0x80);
+        Serial.rx.insert(Serial.rx.end(), bad.begin(), bad.end());
+        loop();
+        QCOMPARE(int(Serial.tx.size()), 0);
+    }
+
+    // 창문 펌웨어: 부팅 → OPEN(ACK/ACTION → RUN_MS 후 DONE) → 모르는 opcode → STATUS
+    void windowFirmwareAgrees() {
+        using namespace WindowSketch;
+        ArduinoShim::nowMs = 0;
+        setup();
+        std::vector<Frame> f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].op, quint8(OpReady));
+
+        send(Serial, 3, OpOpen);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 2);
+        QCOMPARE(f[0].op, quint8(OpAck));
+        QCOMPARE(f[0].byteAt(0), quint8(3));
+        QCOMPARE(f[1].op, quint8(OpAction));
+
+        ArduinoShim::nowMs = 1000;
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].op, quint8(OpDone));
+        QCOMPARE(f[0].byteAt(0), quint8(3));
+        QCOMPARE(f[0].byteAt(1), quint8(OpOpen));
+        QCOMPARE(f[0].le16At(2), quint16(1000));
+
+        send(Serial, 4, 0x7F);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 1);
+        QCOMPARE(f[0].byteAt(1), quint8(AckUnknown));
+
+        send(Serial, 5, OpStatus);
+        loop();
+        f = drain(Serial);
+        QCOMPARE(int(f.size()), 2);
+        QCOMPARE(f[1].op, quint8(OpState));
+        QCOMPARE(f[1].byteAt(0), quint8(1));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSerialFrame)
+#include "tst_serialframe.moc"